@@ -26,6 +26,7 @@ struct ObserverI
     virtual void handler2_v(double value) = 0;
     virtual void handler3_v(ComplexParam& param) = 0;
     virtual void connect(Subject& subject) = 0;
+    virtual void connect_group(Subject& subject) = 0;
     virtual ~ObserverI() = default;
 };
 
@@ -34,6 +35,7 @@ struct Subject
     FastSignal<void()> sig;
     FastSignal<void(double)> sig_double;
     FastSignal<void(ComplexParam&)> sig_cp;
+    SignalGroup<void(), void(double), void(ComplexParam&)> sig_group;
 
     fteng::signal<void()> fteng_sig;
     fteng::signal<void(double)> fteng_sig_double;
@@ -64,6 +66,8 @@ struct Subject
     void sig_observers() { sig(); }
     void sig_observers(double value) { sig_double(value); }
     void sig_observers(ComplexParam& param) { sig_cp(param); }
+    void sig_observers(double value, ComplexParam& param) { sig(); sig_double(value); sig_cp(param); }
+    void sig_group_observers(double value, ComplexParam& param) { sig_group({}, std::tuple<double>(value), std::tie(param)); }
 
     void fteng_sig_observers() { fteng_sig(); }
     void fteng_sig_observers(double value) { fteng_sig_double(value); }
@@ -95,6 +99,11 @@ struct Observer : public ObserverI
         subject.fteng_sig_cp.connect<&Observer::handler3>(this);
     }
 
+    void connect_group(Subject& subject)
+    {
+        subject.sig_group.add<&Observer::handler1, &Observer::handler2, &Observer::handler3>(this);
+    }
+
     void connect_v(Subject& subject)
     {
         subject.sig.add<&Observer::handler1_v>(this);
@@ -133,9 +142,10 @@ auto getFactories()
 
 static auto fac = getFactories();
 
-void create_observers()
+// A fixed seed gives the same observers and order on every run, for comparable results
+void create_observers(unsigned seed = time(nullptr))
 {
-    std::mt19937 gen(time(nullptr));
+    std::mt19937 gen(seed);
     std::uniform_int_distribution<> dis(0, DIST_COUNT - 1);
 
     for (int i = 0; i < OBSERVERS_COUNT; ++i) {
@@ -149,3 +159,16 @@ void create_observers()
         observer->connect(subject);
     }
 }
+
+// Only for the SignalGroup benchmarks, the other signals keep the heap layout they had without the group
+void connect_group_observers()
+{
+    static bool connected = false;
+
+    if (connected)
+        return;
+
+    for (auto& observer : observers)
+        observer->connect_group(subject);
+    connected = true;
+}
@@ -1,7 +1,13 @@
+#include <cstdlib>
+#include <map>
+#include <unordered_map>
+#include <memory_resource>
+
 #include <benchmark/benchmark.h>
 
 #include "bench_base.hpp"
 #include "fastsignal.hpp"
+#include "perf_counters.hpp"
 #include <signals.hpp>
 
 using namespace fastsignal;
@@ -17,8 +23,50 @@ void setup([[maybe_unused]] const benchmark::State& state)
     created = true;
 }
 
+void setup_group(const benchmark::State& state)
+{
+    setup(state);
+    connect_group_observers();
+}
+
+// Hardware counters of the benchmark loop, reported per slot call. Collected when the FASTSIGNAL_PERF_COUNTERS
+// environment variable is set, the counters the kernel or the CPU don't provide are left out.
+class SlotCounters
+{
+    benchmark::State& state;
+    size_t slots_per_iteration;
+
+    static PerfCounters* counters() {
+        static std::unique_ptr<PerfCounters> counters =
+            std::getenv("FASTSIGNAL_PERF_COUNTERS") ? std::make_unique<PerfCounters>() : nullptr;
+        return counters && counters->any_available() ? counters.get() : nullptr;
+    }
+
+public:
+    SlotCounters(benchmark::State& state, size_t slots_per_iteration)
+        : state(state), slots_per_iteration(slots_per_iteration) {
+        if (PerfCounters* perf = counters())
+            perf->start();
+    }
+
+    ~SlotCounters() {
+        PerfCounters* perf = counters();
+        if (!perf)
+            return;
+
+        perf->stop();
+        double slot_calls = static_cast<double>(state.iterations()) * slots_per_iteration;
+        for (size_t i = 0; i < static_cast<size_t>(PerfEvent::count); i++) {
+            auto event = static_cast<PerfEvent>(i);
+            if (perf->available(event))
+                state.counters[perf_event_name(event)] = static_cast<double>(perf->value(event)) / slot_calls;
+        }
+    }
+};
+
 static void BM_observer_call(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         for (auto &observer : observers)
             observer->handler1_v();
@@ -28,6 +76,7 @@ BENCHMARK(BM_observer_call)->Setup(setup)->Name("observers_call");
 
 static void BM_sig_call(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.sig();
     }
@@ -36,7 +85,7 @@ BENCHMARK(BM_sig_call)->Setup(setup)->Name("sig_call");
 
 static void BM_fteng_sig_call(benchmark::State& state)
 {
-
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.fteng_sig();
     }
@@ -45,6 +94,7 @@ BENCHMARK(BM_fteng_sig_call)->Setup(setup)->Name("fteng_sig_call");
 
 static void BM_notify_observers(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.notify_observers();
     }
@@ -53,14 +103,34 @@ BENCHMARK(BM_notify_observers)->Setup(setup)->Name("notify_observers()");
 
 static void BM_sig_observers(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.sig_observers();
     }
 }
 BENCHMARK(BM_sig_observers)->Setup(setup)->Name("sig_observers()");
 
+static void BM_sig_all_observers(benchmark::State& state)
+{
+    SlotCounters slot_counters(state, 3 * observers.size());
+    for (auto _ : state) {
+        subject.sig_observers(0.005f, complex_param);
+    }
+}
+BENCHMARK(BM_sig_all_observers)->Setup(setup)->Name("sig_observers(all)");
+
+static void BM_sig_group_observers(benchmark::State& state)
+{
+    SlotCounters slot_counters(state, 3 * observers.size());
+    for (auto _ : state) {
+        subject.sig_group_observers(0.005f, complex_param);
+    }
+}
+BENCHMARK(BM_sig_group_observers)->Setup(setup_group)->Name("sig_group_observers(all)");
+
 static void BM_fteng_sig_observers(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.fteng_sig_observers();
     }
@@ -69,6 +139,7 @@ BENCHMARK(BM_fteng_sig_observers)->Setup(setup)->Name("fteng_sig_observers()");
 
 static void BM_notify_observers2(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.notify_observers(0.005f);
     }
@@ -77,6 +148,7 @@ BENCHMARK(BM_notify_observers2)->Setup(setup)->Name("notify_observers(double)");
 
 static void BM_sig_observers2(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.sig_observers(0.005f);
     }
@@ -85,6 +157,7 @@ BENCHMARK(BM_sig_observers2)->Setup(setup)->Name("sig_observers(double)");
 
 static void BM_fteng_sig_observers2(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.fteng_sig_observers(0.005f);
     }
@@ -93,6 +166,7 @@ BENCHMARK(BM_fteng_sig_observers2)->Setup(setup)->Name("fteng_sig_observers(doub
 
 static void BM_notify_observers3(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.notify_observers(complex_param);
     }
@@ -101,6 +175,7 @@ BENCHMARK(BM_notify_observers3)->Setup(setup)->Name("notify_observers(complex_pa
 
 static void BM_sig_observers3(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.sig_observers(complex_param);
     }
@@ -109,8 +184,820 @@ BENCHMARK(BM_sig_observers3)->Setup(setup)->Name("sig_observers(complex_param)")
 
 static void BM_fteng_sig_observers3(benchmark::State& state)
 {
+    SlotCounters slot_counters(state, observers.size());
     for (auto _ : state) {
         subject.fteng_sig_observers(complex_param);
     }
 }
 BENCHMARK(BM_fteng_sig_observers3)->Setup(setup)->Name("fteng_sig_observers(complex_param)");
+
+static void BM_sig_connect(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    for (auto _ : state) {
+        FastSignal<void()> sig;
+        for (auto &observer : local_observers)
+            sig.add<&Observer<0>::handler1>(&observer);
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect)->Name("sig_connect");
+
+static void BM_sig_connect_arena(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    std::vector<std::byte> buffer(2 * 1024 * 1024);
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        FastSignal<void()> sig(&arena);
+        for (auto &observer : local_observers)
+            sig.add<&Observer<0>::handler1>(&observer);
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_arena)->Name("sig_connect(arena)");
+
+static void BM_sig_connect_reserve(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    for (auto _ : state) {
+        FastSignal<void()> sig;
+        sig.reserve(local_observers.size());
+        for (auto &observer : local_observers)
+            sig.add<&Observer<0>::handler1>(&observer);
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_reserve)->Name("sig_connect(reserve)");
+
+static void BM_sig_connect_range(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    for (auto _ : state) {
+        FastSignal<void()> sig;
+        sig.add_range<&Observer<0>::handler1>(local_observers.begin(), local_observers.end());
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_range)->Name("sig_connect(add_range)");
+
+static void BM_sig_connect_permanent(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    for (auto _ : state) {
+        FastSignal<void()> sig;
+        for (auto &observer : local_observers)
+            sig.add_permanent<&Observer<0>::handler1>(&observer);
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_permanent)->Name("sig_connect(add_permanent)");
+
+struct DisconnectableObserver : public Disconnectable
+{
+    volatile double sink = 0;
+
+    void handler1() { sink++; }
+};
+
+static void BM_sig_connect_disconnectable(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::vector<DisconnectableObserver> local_observers(OBSERVERS_COUNT);
+        FastSignal<void()> sig;
+        for (auto &observer : local_observers)
+            sig.add<&DisconnectableObserver::handler1>(&observer);
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_disconnectable)->Name("sig_connect(disconnectable)");
+
+static void BM_sig_connect_disconnectable_range(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::vector<DisconnectableObserver> local_observers(OBSERVERS_COUNT);
+        FastSignal<void()> sig;
+        sig.add_range<&DisconnectableObserver::handler1>(local_observers.begin(), local_observers.end());
+        benchmark::DoNotOptimize(sig);
+    }
+}
+BENCHMARK(BM_sig_connect_disconnectable_range)->Name("sig_connect(disconnectable, add_range)");
+
+struct MultiObserver : public Disconnectable
+{
+    volatile double sink = 0;
+
+    void handler1() { sink++; }
+    void handler2(double value) { sink += value; }
+    void handler3(ComplexParam& param) { ++param.value; }
+};
+
+// Connects every observer to 3 signals and destroys them, which disconnects them.
+// The emissions of the empty signals compact them for the next iteration.
+static void BM_sig_connect_teardown_add(benchmark::State& state)
+{
+    FastSignal<void()> sig;
+    FastSignal<void(double)> sig_double;
+    FastSignal<void(ComplexParam&)> sig_cp;
+    for (auto _ : state) {
+        std::vector<MultiObserver> local_observers(OBSERVERS_COUNT);
+        for (auto &observer : local_observers) {
+            sig.add<&MultiObserver::handler1>(&observer);
+            sig_double.add<&MultiObserver::handler2>(&observer);
+            sig_cp.add<&MultiObserver::handler3>(&observer);
+        }
+        sig();
+        sig_double(0.0);
+        sig_cp(complex_param);
+    }
+}
+BENCHMARK(BM_sig_connect_teardown_add)->Name("sig_connect_teardown(add x3)");
+
+static void BM_sig_connect_teardown_all(benchmark::State& state)
+{
+    FastSignal<void()> sig;
+    FastSignal<void(double)> sig_double;
+    FastSignal<void(ComplexParam&)> sig_cp;
+    for (auto _ : state) {
+        std::vector<MultiObserver> local_observers(OBSERVERS_COUNT);
+        for (auto &observer : local_observers) {
+            connect_all<&MultiObserver::handler1, &MultiObserver::handler2, &MultiObserver::handler3>(
+                &observer, sig, sig_double, sig_cp);
+        }
+        sig();
+        sig_double(0.0);
+        sig_cp(complex_param);
+    }
+}
+BENCHMARK(BM_sig_connect_teardown_all)->Name("sig_connect_teardown(connect_all)");
+
+// A scene of signals and the observers connected to them, destroyed in one order or the other
+struct TeardownScene
+{
+    std::unique_ptr<FastSignal<void()>> sig = std::make_unique<FastSignal<void()>>();
+    std::unique_ptr<FastSignal<void(double)>> sig_double = std::make_unique<FastSignal<void(double)>>();
+    std::unique_ptr<FastSignal<void(ComplexParam&)>> sig_cp = std::make_unique<FastSignal<void(ComplexParam&)>>();
+    std::unique_ptr<std::vector<MultiObserver>> observers = std::make_unique<std::vector<MultiObserver>>(OBSERVERS_COUNT);
+
+    TeardownScene() {
+        for (auto &observer : *observers) {
+            sig->add<&MultiObserver::handler1>(&observer);
+            sig_double->add<&MultiObserver::handler2>(&observer);
+            sig_cp->add<&MultiObserver::handler3>(&observer);
+        }
+    }
+
+    void destroy(bool signals_first) {
+        if (signals_first) {
+            sig.reset();
+            sig_double.reset();
+            sig_cp.reset();
+            observers.reset();
+        } else {
+            observers.reset();
+            sig.reset();
+            sig_double.reset();
+            sig_cp.reset();
+        }
+    }
+
+    // The scope destroys what it adopted last first
+    void adopt(TeardownScope &teardown, bool signals_first) {
+        if (signals_first)
+            teardown.adopt(std::move(observers));
+        teardown.adopt(std::move(sig_cp));
+        teardown.adopt(std::move(sig_double));
+        teardown.adopt(std::move(sig));
+        if (!signals_first)
+            teardown.adopt(std::move(observers));
+    }
+};
+
+template<bool signals_first, bool in_scope>
+static void BM_teardown(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto scene = std::make_unique<TeardownScene>();
+        if constexpr (in_scope) {
+            auto teardown = std::make_unique<TeardownScope>();
+            scene->adopt(*teardown, signals_first);
+            state.ResumeTiming();
+            teardown.reset();
+        } else {
+            state.ResumeTiming();
+            scene->destroy(signals_first);
+        }
+    }
+}
+BENCHMARK(BM_teardown<false, false>)->Name("teardown(observers first)");
+BENCHMARK(BM_teardown<true, false>)->Name("teardown(signals first)");
+BENCHMARK(BM_teardown<false, true>)->Name("teardown(observers first, TeardownScope)");
+BENCHMARK(BM_teardown<true, true>)->Name("teardown(signals first, TeardownScope)");
+
+constexpr int EVENT_COUNT = 256;
+constexpr int EVENT_OBSERVERS_COUNT = 8;
+
+template<typename Bus>
+static void emit_events(benchmark::State& state, Bus& bus)
+{
+    std::vector<Observer<0>> local_observers(EVENT_OBSERVERS_COUNT);
+    for (int id = 0; id < EVENT_COUNT; ++id) {
+        for (auto &observer : local_observers)
+            bus[id].template add<&Observer<0>::handler2>(&observer);
+    }
+
+    for (auto _ : state) {
+        for (int id = 0; id < EVENT_COUNT; ++id)
+            bus[id](0.005);
+    }
+}
+
+static void BM_event_bus(benchmark::State& state)
+{
+    EventBus<void(double)> bus(EVENT_COUNT);
+    std::vector<Observer<0>> local_observers(EVENT_OBSERVERS_COUNT);
+    for (int id = 0; id < EVENT_COUNT; ++id) {
+        for (auto &observer : local_observers)
+            bus.add<&Observer<0>::handler2>(id, &observer);
+    }
+
+    for (auto _ : state) {
+        for (int id = 0; id < EVENT_COUNT; ++id)
+            bus(id, 0.005);
+    }
+}
+BENCHMARK(BM_event_bus)->Name("event_bus");
+
+static void BM_event_unordered_map(benchmark::State& state)
+{
+    std::unordered_map<int, FastSignal<void(double)>> bus;
+    emit_events(state, bus);
+}
+BENCHMARK(BM_event_unordered_map)->Name("event_unordered_map");
+
+static void BM_event_map(benchmark::State& state)
+{
+    std::map<int, FastSignal<void(double)>> bus;
+    emit_events(state, bus);
+}
+BENCHMARK(BM_event_map)->Name("event_map");
+
+constexpr int BURST_COUNT = 100;
+constexpr int BURST_OBSERVERS_COUNT = 1000;
+
+struct BurstObserver
+{
+    size_t calls = 0;
+    volatile double sink = 0;
+
+    void handler(double value) { ++calls; sink = value; }
+};
+
+static void report_slot_calls(benchmark::State& state, const std::vector<BurstObserver>& burst_observers)
+{
+    size_t calls = 0;
+    for (auto &observer : burst_observers)
+        calls += observer.calls;
+    state.counters["slot_calls"] = benchmark::Counter(calls, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_sig_burst(benchmark::State& state)
+{
+    std::vector<BurstObserver> burst_observers(BURST_OBSERVERS_COUNT);
+    FastSignal<void(double)> sig;
+    for (auto &observer : burst_observers)
+        sig.add<&BurstObserver::handler>(&observer);
+
+    for (auto _ : state) {
+        for (int i = 0; i < BURST_COUNT; ++i)
+            sig(i);
+    }
+    report_slot_calls(state, burst_observers);
+}
+BENCHMARK(BM_sig_burst)->Name("sig_burst");
+
+static void BM_coalescing_sig_burst(benchmark::State& state)
+{
+    std::vector<BurstObserver> burst_observers(BURST_OBSERVERS_COUNT);
+    CoalescingGroup group;
+    CoalescingSignal<void(double)> sig(group);
+    for (auto &observer : burst_observers)
+        sig.add<&BurstObserver::handler>(&observer);
+
+    for (auto _ : state) {
+        for (int i = 0; i < BURST_COUNT; ++i)
+            sig(i);
+        group.flush();
+    }
+    report_slot_calls(state, burst_observers);
+}
+BENCHMARK(BM_coalescing_sig_burst)->Name("coalescing_sig_burst");
+
+constexpr int FILTER_KEY_COUNT = 100;
+
+struct IdObserver
+{
+    int id = 0;
+    volatile int sink = 0;
+
+    void handler(int value)
+    {
+        if (value != id)
+            return;
+        sink = value;
+    }
+
+    void handler_filtered(int value) { sink = value; }
+};
+
+static void BM_sig_unfiltered(benchmark::State& state)
+{
+    std::vector<IdObserver> id_observers(OBSERVERS_COUNT);
+    FastSignal<void(int)> sig;
+    for (int i = 0; i < OBSERVERS_COUNT; ++i) {
+        id_observers[i].id = i % FILTER_KEY_COUNT;
+        sig.add<&IdObserver::handler>(&id_observers[i]);
+    }
+
+    for (auto _ : state) {
+        for (int key = 0; key < FILTER_KEY_COUNT; ++key)
+            sig(key);
+    }
+}
+BENCHMARK(BM_sig_unfiltered)->Name("sig_unfiltered");
+
+static void BM_sig_filtered(benchmark::State& state)
+{
+    std::vector<IdObserver> id_observers(OBSERVERS_COUNT);
+    FastSignal<void(int)> sig;
+    for (int i = 0; i < OBSERVERS_COUNT; ++i) {
+        id_observers[i].id = i % FILTER_KEY_COUNT;
+        sig.add_filtered<&IdObserver::handler_filtered>(id_observers[i].id, &id_observers[i]);
+    }
+
+    for (auto _ : state) {
+        for (int key = 0; key < FILTER_KEY_COUNT; ++key)
+            sig(key);
+    }
+}
+BENCHMARK(BM_sig_filtered)->Name("sig_filtered");
+
+constexpr int CHAIN_OBSERVERS_COUNT = 16;
+
+struct Relay
+{
+    FastSignal<void(double)> *next = nullptr;
+
+    void relay(double value) { (*next)(value); }
+};
+
+static void BM_sig_chain_relay(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(CHAIN_OBSERVERS_COUNT);
+    std::vector<FastSignal<void(double)>> chain(state.range(0) + 1);
+    std::vector<Relay> relays(state.range(0));
+    for (size_t i = 0; i < relays.size(); ++i) {
+        relays[i].next = &chain[i + 1];
+        chain[i].add<&Relay::relay>(&relays[i]);
+    }
+    for (auto &observer : local_observers)
+        chain.back().add<&Observer<0>::handler2>(&observer);
+
+    for (auto _ : state) {
+        chain.front()(0.005);
+    }
+}
+BENCHMARK(BM_sig_chain_relay)->Name("sig_chain(relay)")->RangeMultiplier(2)->Range(1, 32);
+
+static void BM_sig_chain_forward(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(CHAIN_OBSERVERS_COUNT);
+    std::vector<FastSignal<void(double)>> chain(state.range(0) + 1);
+    for (size_t i = 0; i + 1 < chain.size(); ++i)
+        chain[i].forward_to(chain[i + 1]);
+    for (auto &observer : local_observers)
+        chain.back().add<&Observer<0>::handler2>(&observer);
+
+    for (auto _ : state) {
+        chain.front()(0.005);
+    }
+}
+BENCHMARK(BM_sig_chain_forward)->Name("sig_chain(forward_to)")->RangeMultiplier(2)->Range(1, 32);
+
+constexpr int ONCE_COUNT = 16;
+
+struct OneShotObserver
+{
+    ConnectionView conn;
+    volatile int sink = 0;
+
+    void handler() { sink++; }
+    void handler_disconnect() { sink++; conn.disconnect(); }
+};
+
+static void BM_sig_one_shot_disconnect(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    std::vector<OneShotObserver> one_shot_observers(ONCE_COUNT);
+    FastSignal<void()> sig;
+    for (auto &observer : local_observers)
+        sig.add<&Observer<0>::handler1>(&observer);
+
+    for (auto _ : state) {
+        for (auto &observer : one_shot_observers)
+            observer.conn = sig.add<&OneShotObserver::handler_disconnect>(&observer);
+        sig();
+    }
+}
+BENCHMARK(BM_sig_one_shot_disconnect)->Name("sig_one_shot(disconnect)");
+
+static void BM_sig_one_shot_once(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    std::vector<OneShotObserver> one_shot_observers(ONCE_COUNT);
+    FastSignal<void()> sig;
+    for (auto &observer : local_observers)
+        sig.add<&Observer<0>::handler1>(&observer);
+
+    for (auto _ : state) {
+        for (auto &observer : one_shot_observers)
+            sig.add_once<&OneShotObserver::handler>(&observer);
+        sig();
+    }
+}
+BENCHMARK(BM_sig_one_shot_once)->Name("sig_one_shot(add_once)");
+
+constexpr int SIGNAL_OWNERS_COUNT = 1000;
+constexpr int SLOTS_PER_SIGNAL = 8;
+
+struct SignalOwner
+{
+    FastSignal<void()> changed;
+};
+
+// Growing a vector of signal owners moves every signal on reallocation, the cost of a move
+// must not depend on the number of connected slots
+static void BM_sig_vector_growth(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(SLOTS_PER_SIGNAL);
+
+    for (auto _ : state) {
+        std::vector<SignalOwner> owners;
+        for (int i = 0; i < SIGNAL_OWNERS_COUNT; ++i) {
+            owners.emplace_back();
+            for (auto &observer : local_observers)
+                owners.back().changed.add<&Observer<0>::handler1>(&observer);
+        }
+        benchmark::DoNotOptimize(owners.data());
+    }
+}
+BENCHMARK(BM_sig_vector_growth)->Name("sig_vector_growth");
+
+static void BM_sig_swap(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    FastSignal<void()> sig1, sig2;
+    for (auto &observer : local_observers) {
+        sig1.add<&Observer<0>::handler1>(&observer);
+        sig2.add<&Observer<0>::handler1>(&observer);
+    }
+
+    for (auto _ : state) {
+        std::swap(sig1, sig2);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_sig_swap)->Name("sig_swap");
+
+// The slots of connect_v, connected through the interface as the dynamic type is only known at runtime
+static void BM_sig_call_virtual(benchmark::State& state)
+{
+    setup(state);
+    FastSignal<void()> sig;
+    FastSignal<void(ComplexParam&)> sig_cp;
+    for (auto &observer : observers) {
+        sig.add<&ObserverI::handler1_v>(observer.get());
+        sig_cp.add<&ObserverI::handler3_v>(observer.get());
+    }
+
+    for (auto _ : state) {
+        sig();
+        sig_cp(complex_param);
+    }
+}
+BENCHMARK(BM_sig_call_virtual)->Name("sig_call(virtual)");
+
+static void BM_sig_call_devirtualized(benchmark::State& state)
+{
+    setup(state);
+    FastSignal<void()> sig;
+    FastSignal<void(ComplexParam&)> sig_cp;
+    for (auto &observer : observers) {
+        sig.add_devirtualized<&ObserverI::handler1_v>(observer.get());
+        sig_cp.add_devirtualized<&ObserverI::handler3_v>(observer.get());
+    }
+
+    for (auto _ : state) {
+        sig();
+        sig_cp(complex_param);
+    }
+}
+BENCHMARK(BM_sig_call_devirtualized)->Name("sig_call(devirtualized)");
+
+// Blocked slots stay in the slot array, the emission has to skip them.
+// The argument is the percentage of blocked slots.
+static void BM_sig_dead_slots(benchmark::State& state)
+{
+    std::vector<Observer<0>> local_observers(OBSERVERS_COUNT);
+    FastSignal<void()> sig;
+    std::vector<ConnectionView> connections;
+    for (auto &observer : local_observers)
+        connections.push_back(sig.add<&Observer<0>::handler1>(&observer));
+
+    std::mt19937 gen(0);
+    std::shuffle(connections.begin(), connections.end(), gen);
+    size_t blocked_count = connections.size() * state.range(0) / 100;
+    for (size_t i = 0; i < blocked_count; ++i)
+        connections[i].block();
+
+    for (auto _ : state) {
+        sig();
+    }
+}
+BENCHMARK(BM_sig_dead_slots)->Name("sig_dead_slots")->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+
+constexpr int SCATTERED_OBSERVERS_COUNT = 20000;
+
+// Large enough that every observer sits on its own cache lines
+struct ScatteredObserver
+{
+    char payload[192];
+    volatile int sink = 0;
+
+    void handler() { sink++; }
+};
+
+struct ScatteredSubject
+{
+    std::vector<std::unique_ptr<ScatteredObserver>> observers;
+    FastSignal<void()> sig;
+
+    ScatteredSubject() {
+        for (int i = 0; i < SCATTERED_OBSERVERS_COUNT; ++i)
+            observers.push_back(std::make_unique<ScatteredObserver>());
+
+        // Connection order unrelated to the address order, the hardware prefetcher can't follow it
+        std::mt19937 gen(0);
+        std::shuffle(observers.begin(), observers.end(), gen);
+        for (auto &observer : observers)
+            sig.add<&ScatteredObserver::handler>(observer.get());
+    }
+};
+
+// Evicts the observers from the caches, the emission then misses on every observer.
+// The eviction isn't timed but is much slower than the emission, the cold variants run a fixed number of iterations.
+constexpr int COLD_ITERATIONS = 300;
+
+static void evict_caches()
+{
+    constexpr size_t EVICT_SIZE = 64 * 1024 * 1024;
+    static std::vector<char> buffer(EVICT_SIZE);
+
+    for (size_t i = 0; i < buffer.size(); i += 64)
+        buffer[i]++;
+    benchmark::ClobberMemory();
+}
+
+static void BM_sig_scattered(benchmark::State& state)
+{
+    ScatteredSubject scattered;
+    for (auto _ : state) {
+        scattered.sig();
+    }
+}
+BENCHMARK(BM_sig_scattered)->Name("sig_scattered");
+
+template<size_t Distance>
+static void BM_sig_scattered_prefetched(benchmark::State& state)
+{
+    ScatteredSubject scattered;
+    for (auto _ : state) {
+        scattered.sig.emit_prefetched<Distance>();
+    }
+}
+BENCHMARK(BM_sig_scattered_prefetched<8>)->Name("sig_scattered_prefetched<8>");
+
+static void BM_sig_scattered_cold(benchmark::State& state)
+{
+    ScatteredSubject scattered;
+    for (auto _ : state) {
+        state.PauseTiming();
+        evict_caches();
+        state.ResumeTiming();
+
+        scattered.sig();
+    }
+}
+BENCHMARK(BM_sig_scattered_cold)->Name("sig_scattered(cold)")->Iterations(COLD_ITERATIONS);
+
+template<size_t Distance>
+static void BM_sig_scattered_cold_prefetched(benchmark::State& state)
+{
+    ScatteredSubject scattered;
+    for (auto _ : state) {
+        state.PauseTiming();
+        evict_caches();
+        state.ResumeTiming();
+
+        scattered.sig.emit_prefetched<Distance>();
+    }
+}
+BENCHMARK(BM_sig_scattered_cold_prefetched<4>)->Name("sig_scattered_prefetched<4>(cold)")->Iterations(COLD_ITERATIONS);
+BENCHMARK(BM_sig_scattered_cold_prefetched<8>)->Name("sig_scattered_prefetched<8>(cold)")->Iterations(COLD_ITERATIONS);
+BENCHMARK(BM_sig_scattered_cold_prefetched<16>)->Name("sig_scattered_prefetched<16>(cold)")->Iterations(COLD_ITERATIONS);
+BENCHMARK(BM_sig_scattered_cold_prefetched<32>)->Name("sig_scattered_prefetched<32>(cold)")->Iterations(COLD_ITERATIONS);
+
+constexpr int LOOP_SLOTS_COUNT = 16;
+
+struct LoopListener
+{
+    std::atomic<int> sink{0};
+
+    void handler(const int &value) { sink.fetch_add(value, std::memory_order_relaxed); }
+};
+
+// The listener bounces every call to its thread by hand, one task per slot
+struct BouncingListener
+{
+    struct Call : EventLoop::Task
+    {
+        BouncingListener *listener;
+        int value;
+
+        Call(BouncingListener *listener, int value) : listener(listener), value(value) {
+            run = [](EventLoop::Task *task, bool cancelled) {
+                std::unique_ptr<Call> call(static_cast<Call*>(task));
+                if (!cancelled)
+                    call->listener->inner.handler(call->value);
+            };
+        }
+    };
+
+    EventLoop *loop = nullptr;
+    LoopListener inner;
+
+    void handler(const int &value) { loop->post(new Call(this, value)); }
+};
+
+static void report_wakeups(benchmark::State& state, const EventLoop& loop)
+{
+    state.counters["wakeups/emission"] = benchmark::Counter(
+        static_cast<double>(loop.wakeups()) / static_cast<double>(state.iterations()));
+}
+
+static void BM_sig_event_loop_bounce(benchmark::State& state)
+{
+    EventLoop loop;
+    std::thread thread([&loop]() { loop.run(); });
+    while (loop.is_current())
+        std::this_thread::yield();
+
+    std::vector<BouncingListener> listeners(LOOP_SLOTS_COUNT);
+    FastSignal<void(const int&)> sig;
+    for (auto &listener : listeners) {
+        listener.loop = &loop;
+        sig.add<&BouncingListener::handler>(&listener);
+    }
+
+    for (auto _ : state) {
+        sig(1);
+    }
+
+    loop.stop();
+    thread.join();
+    report_wakeups(state, loop);
+}
+BENCHMARK(BM_sig_event_loop_bounce)->Name("sig_event_loop(bounce per slot)");
+
+static void BM_sig_event_loop_add_on(benchmark::State& state)
+{
+    EventLoop loop;
+    std::thread thread([&loop]() { loop.run(); });
+    while (loop.is_current())
+        std::this_thread::yield();
+
+    std::vector<LoopListener> listeners(LOOP_SLOTS_COUNT);
+    FastSignal<void(const int&)> sig;
+    for (auto &listener : listeners)
+        sig.add_on<&LoopListener::handler>(loop, &listener);
+
+    for (auto _ : state) {
+        sig(1);
+    }
+
+    loop.stop();
+    thread.join();
+    report_wakeups(state, loop);
+}
+BENCHMARK(BM_sig_event_loop_add_on)->Name("sig_event_loop(add_on)");
+
+struct SpscConsumer
+{
+    std::atomic<size_t> received{0};
+
+    void handler(int) { received.fetch_add(1, std::memory_order_relaxed); }
+    void handler_cp(ComplexParam& param) { ++param.value; received.fetch_add(1, std::memory_order_relaxed); }
+};
+
+template<typename Signal>
+static void process_until(Signal &sig, std::atomic<bool> &done)
+{
+    while (!done.load(std::memory_order_acquire)) {
+        if (!sig.process())
+            std::this_thread::yield();
+    }
+    sig.process();
+}
+
+// Emissions per second from the producer to a consumer thread
+template<typename Signature, auto handler, typename Arg>
+static void spsc_throughput(benchmark::State& state, Arg &&arg)
+{
+    SpscSignal<Signature> sig;
+    SpscConsumer consumer;
+    sig.template add<handler>(&consumer);
+
+    std::atomic<bool> done{false};
+    std::thread thread([&sig, &done]() { process_until(sig, done); });
+
+    for (auto _ : state) {
+        sig(arg);
+    }
+
+    done.store(true, std::memory_order_release);
+    thread.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_spsc_throughput_int(benchmark::State& state)
+{
+    spsc_throughput<void(int), &SpscConsumer::handler>(state, 1);
+}
+BENCHMARK(BM_spsc_throughput_int)->Name("spsc_throughput(int)");
+
+static void BM_spsc_throughput_cp(benchmark::State& state)
+{
+    spsc_throughput<void(ComplexParam&), &SpscConsumer::handler_cp>(state, complex_param);
+}
+BENCHMARK(BM_spsc_throughput_cp)->Name("spsc_throughput(ComplexParam)");
+
+// Half of a round trip: the consumer thread's slot emits back on a second ring
+template<typename Signature, auto handler, typename Arg>
+static void spsc_latency(benchmark::State& state, Arg &&arg)
+{
+    struct Echo
+    {
+        SpscSignal<Signature> *back;
+        using Value = std::conditional_t<std::is_lvalue_reference_v<Arg>, Arg, const Arg&>;
+        void echo(Value value) { (*back)(value); }
+    };
+
+    SpscSignal<Signature> forth, back;
+    Echo echo{&back};
+    forth.template add<&Echo::echo>(&echo);
+
+    SpscConsumer consumer;
+    back.template add<handler>(&consumer);
+
+    std::atomic<bool> done{false};
+    std::thread thread([&forth, &done]() { process_until(forth, done); });
+
+    size_t expected = 0;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        forth(arg);
+        ++expected;
+        while (consumer.received.load(std::memory_order_relaxed) != expected) {
+            if (!back.process())
+                std::this_thread::yield();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        state.SetIterationTime(elapsed.count() / 2);
+    }
+
+    done.store(true, std::memory_order_release);
+    thread.join();
+}
+
+static void BM_spsc_latency_int(benchmark::State& state)
+{
+    spsc_latency<void(int), &SpscConsumer::handler>(state, 1);
+}
+BENCHMARK(BM_spsc_latency_int)->Name("spsc_one_way_latency(int)")->UseManualTime();
+
+static void BM_spsc_latency_cp(benchmark::State& state)
+{
+    spsc_latency<void(ComplexParam&), &SpscConsumer::handler_cp>(state, complex_param);
+}
+BENCHMARK(BM_spsc_latency_cp)->Name("spsc_one_way_latency(ComplexParam)")->UseManualTime();
@@ -1,14 +1,60 @@
 #include <iostream>
+#include <memory_resource>
 
 #include "fastsignal.hpp"
 
 using namespace fastsignal;
 
+constexpr int ADD_COUNT = 5000;
+
+struct CountingResource : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource *upstream;
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+    CountingResource(std::pmr::memory_resource *upstream) : upstream(upstream) {}
+
+    void *do_allocate(size_t size, size_t alignment) override {
+        ++allocations;
+        bytes += size;
+        return upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void *p, size_t size, size_t alignment) override {
+        upstream->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct Handler : public Disconnectable
+{
+    Handler(std::pmr::memory_resource *mr) : Disconnectable(mr) {}
+    void handle(int) {}
+};
+
+void print_allocations(const char *name, std::pmr::memory_resource *mr, CountingResource &heap)
+{
+    {
+        FastSignal<void(int)> sig(mr);
+        std::pmr::vector<Handler> handlers(mr);
+        handlers.reserve(ADD_COUNT);
+        for (int i = 0; i < ADD_COUNT; ++i)
+            sig.add<&Handler::handle>(&handlers.emplace_back(mr));
+    }
+
+    std::cout << name << ": " << heap.allocations << " heap allocations, " << heap.bytes << " bytes allocated\n";
+}
+
 int main()
 {
     std::cout << "FastSignal: " << sizeof(FastSignal<void(int)>) << '\n';
     std::cout << "Callback: " << sizeof(internal::Callback) << '\n';
     std::cout << "Connection: " << sizeof(internal::Connection) << '\n';
+    std::cout << "Connection record (with control block): " << internal::connection_record_bytes() << '\n';
     std::cout << "ConnectionView: " << sizeof(ConnectionView) << '\n';
     std::cout << "Disconnectable: " << sizeof(Disconnectable) << "\n\n";
 
@@ -22,4 +68,16 @@ int main()
     std::cout << "1 FastSignal disconnectable add = 1 Callback + 1 Connection + 1 Connection* (+ 1 ConnectionView) = ";
     std::cout << sizeof(internal::Callback) + sizeof(internal::Connection) + sizeof(internal::Connection*);
     std::cout << "(" << sizeof(internal::Callback) + sizeof(internal::Connection) + sizeof(internal::Connection*) + sizeof(ConnectionView) << ")" << '\n';
+
+    std::cout << "\n" << ADD_COUNT << " disconnectable adds:\n";
+    {
+        CountingResource heap(std::pmr::new_delete_resource());
+        print_allocations("  global allocator", &heap, heap);
+    }
+    {
+        // The arena's buffers are the only allocations that reach the heap
+        CountingResource heap(std::pmr::new_delete_resource());
+        std::pmr::monotonic_buffer_resource arena(&heap);
+        print_allocations("  monotonic arena", &arena, heap);
+    }
 }
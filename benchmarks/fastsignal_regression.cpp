@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_base.hpp"
+#include "fastsignal.hpp"
+#include "perf_counters.hpp"
+#include <signals.hpp>
+
+using namespace fastsignal;
+
+// Runs the benchmark scenarios with its own timing loop, without any benchmark library.
+// Results (median and p99 per operation, instructions when the counters are available) are written as JSON
+// and compared against a baseline written by a previous run, the exit code is 1 if a scenario regressed.
+//
+// fastsignal_regression [--output FILE] [--baseline FILE] [--threshold PERCENT] [--instructions-threshold PERCENT]
+//                       [--threshold-for NAME=PERCENT]... [--filter TEXT] [--samples N]
+
+constexpr unsigned OBSERVERS_SEED = 92;
+constexpr auto MIN_SAMPLE_TIME = std::chrono::microseconds(500);
+
+struct Scenario
+{
+    std::string name;
+    std::function<void()> run;
+    // Called once before the scenario is measured
+    std::function<void()> setup = nullptr;
+};
+
+struct Result
+{
+    std::string name;
+    double median_ns = 0;
+    double p99_ns = 0;
+    // Per operation, negative when the counters are unavailable
+    double instructions = -1;
+};
+
+struct Options
+{
+    std::string output = "fastsignal_regression.json";
+    std::string baseline;
+    std::string filter;
+    double threshold = 10;
+    double instructions_threshold = 2;
+    std::map<std::string, double> thresholds;
+    int samples = 51;
+};
+
+static std::vector<Scenario> scenarios()
+{
+    static std::vector<Observer<0>> connect_observers(1000);
+
+    return {
+        {"observers_call", []() { for (auto &observer : observers) observer->handler1_v(); }},
+        {"sig_call", []() { subject.sig(); }},
+        {"fteng_sig_call", []() { subject.fteng_sig(); }},
+        {"notify_observers()", []() { subject.notify_observers(); }},
+        {"sig_observers()", []() { subject.sig_observers(); }},
+        {"fteng_sig_observers()", []() { subject.fteng_sig_observers(); }},
+        {"notify_observers(double)", []() { subject.notify_observers(0.005); }},
+        {"sig_observers(double)", []() { subject.sig_observers(0.005); }},
+        {"fteng_sig_observers(double)", []() { subject.fteng_sig_observers(0.005); }},
+        {"notify_observers(ComplexParam&)", []() { subject.notify_observers(complex_param); }},
+        {"sig_observers(ComplexParam&)", []() { subject.sig_observers(complex_param); }},
+        {"fteng_sig_observers(ComplexParam&)", []() { subject.fteng_sig_observers(complex_param); }},
+        {"sig_observers(all)", []() { subject.sig_observers(0.005, complex_param); }},
+        {"sig_group_observers(all)", []() { subject.sig_group_observers(0.005, complex_param); }, connect_group_observers},
+        {"sig_connect", []() {
+            FastSignal<void()> sig;
+            for (auto &observer : connect_observers)
+                sig.add<&Observer<0>::handler1>(&observer);
+        }},
+    };
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[rank];
+}
+
+static Result measure(const Scenario &scenario, int samples, PerfCounters &counters)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Enough iterations per sample for the clock's resolution, also warms up the caches
+    size_t iterations = 1;
+    for (;;) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            scenario.run();
+        if (Clock::now() - start >= MIN_SAMPLE_TIME)
+            break;
+        iterations *= 2;
+    }
+
+    std::vector<double> times;
+    std::vector<double> instructions;
+    for (int sample = 0; sample < samples; sample++) {
+        counters.start();
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            scenario.run();
+        auto elapsed = Clock::now() - start;
+        counters.stop();
+
+        times.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / iterations);
+        instructions.push_back(static_cast<double>(counters.value(PerfEvent::instructions)) / iterations);
+    }
+
+    Result result;
+    result.name = scenario.name;
+    result.median_ns = percentile(times, 0.5);
+    result.p99_ns = percentile(times, 0.99);
+    if (counters.available(PerfEvent::instructions))
+        result.instructions = percentile(instructions, 0.5);
+    return result;
+}
+
+static bool write_results(const std::string &path, const std::vector<Result> &results)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    // One result per line, read back by read_results()
+    out << "{\n\"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        out << "{\"name\": \"" << result.name << "\", \"median_ns\": " << result.median_ns
+            << ", \"p99_ns\": " << result.p99_ns;
+        if (result.instructions >= 0)
+            out << ", \"instructions\": " << result.instructions;
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n}\n";
+    return static_cast<bool>(out);
+}
+
+static bool read_results(const std::string &path, std::map<std::string, Result> &results)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+
+    const std::regex result_regex(
+        "\\{\"name\": \"([^\"]+)\", \"median_ns\": ([0-9.e+-]+), \"p99_ns\": ([0-9.e+-]+)"
+        "(, \"instructions\": ([0-9.e+-]+))?\\},?");
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::smatch match;
+        if (!std::regex_match(line, match, result_regex))
+            continue;
+
+        Result result;
+        result.name = match[1];
+        result.median_ns = std::stod(match[2]);
+        result.p99_ns = std::stod(match[3]);
+        if (match[5].matched)
+            result.instructions = std::stod(match[5]);
+        results[result.name] = result;
+    }
+    return true;
+}
+
+static double change(double value, double baseline)
+{
+    return baseline > 0 ? (value - baseline) / baseline * 100 : 0;
+}
+
+// Returns the number of regressed scenarios
+static int compare(const std::vector<Result> &results, const std::map<std::string, Result> &baseline,
+    const Options &options)
+{
+    int regressions = 0;
+
+    std::printf("\n%-40s %12s %12s %9s %11s\n", "scenario", "baseline ns", "median ns", "change", "instr");
+    for (const Result &result : results) {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end()) {
+            std::printf("%-40s %12s %12.1f %9s\n", result.name.c_str(), "-", result.median_ns, "new");
+            continue;
+        }
+
+        const Result &base = it->second;
+        auto threshold = options.thresholds.find(result.name);
+        double time_threshold = threshold != options.thresholds.end() ? threshold->second : options.threshold;
+        double time_change = change(result.median_ns, base.median_ns);
+        bool regressed = time_change > time_threshold;
+
+        std::string instructions_change = "-";
+        if (result.instructions >= 0 && base.instructions >= 0) {
+            double value = change(result.instructions, base.instructions);
+            regressed = regressed || value > options.instructions_threshold;
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%+.1f%%", value);
+            instructions_change = buffer;
+        }
+
+        std::printf("%-40s %12.1f %12.1f %+8.1f%% %11s%s\n", result.name.c_str(), base.median_ns, result.median_ns,
+            time_change, instructions_change.c_str(), regressed ? "  REGRESSION" : "");
+        if (regressed)
+            ++regressions;
+    }
+
+    return regressions;
+}
+
+static bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--baseline") {
+            options.baseline = value;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--threshold") {
+            options.threshold = std::atof(value.c_str());
+        } else if (arg == "--instructions-threshold") {
+            options.instructions_threshold = std::atof(value.c_str());
+        } else if (arg == "--threshold-for") {
+            size_t separator = value.rfind('=');
+            if (separator == std::string::npos) {
+                std::cerr << "Expected NAME=PERCENT for --threshold-for\n";
+                return false;
+            }
+            options.thresholds[value.substr(0, separator)] = std::atof(value.c_str() + separator + 1);
+        } else if (arg == "--samples") {
+            options.samples = std::max(1, std::atoi(value.c_str()));
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+        return 2;
+
+    create_observers(OBSERVERS_SEED);
+
+    PerfCounters counters;
+    if (!counters.available(PerfEvent::instructions))
+        std::printf("Instruction counter unavailable, comparing times only\n");
+
+    std::vector<Result> results;
+    for (const Scenario &scenario : scenarios()) {
+        if (scenario.name.find(options.filter) == std::string::npos)
+            continue;
+
+        if (scenario.setup)
+            scenario.setup();
+        results.push_back(measure(scenario, options.samples, counters));
+        const Result &result = results.back();
+        std::printf("%-40s median %10.1f ns  p99 %10.1f ns", result.name.c_str(), result.median_ns, result.p99_ns);
+        if (result.instructions >= 0)
+            std::printf("  %10.1f instructions", result.instructions);
+        std::printf("\n");
+    }
+
+    if (!write_results(options.output, results)) {
+        std::cerr << "Can't write " << options.output << "\n";
+        return 2;
+    }
+    std::printf("Results written to %s\n", options.output.c_str());
+
+    if (options.baseline.empty())
+        return 0;
+
+    std::map<std::string, Result> baseline;
+    if (!read_results(options.baseline, baseline)) {
+        std::cerr << "Can't read baseline " << options.baseline << "\n";
+        return 2;
+    }
+
+    int regressions = compare(results, baseline, options);
+    if (regressions) {
+        std::printf("\n%d scenario(s) regressed\n", regressions);
+        return 1;
+    }
+
+    std::printf("\nNo regression\n");
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fastsignal.hpp"
+#include <signals.hpp>
+
+using namespace fastsignal;
+
+#ifndef FASTSIGNAL_RECORD
+#error "fastsignal_replay must be built with FASTSIGNAL_RECORD"
+#endif
+
+// Replays a log written by fastsignal::record (see the README) against FastSignal and fteng::signal.
+// Every run re-creates the signals and executes the same connects, disconnects, emissions and destructions
+// in the recorded order, the median run is reported. The recorded signals may have had any signature,
+// in the replay they're all void(const Payload&) with the argument bytes of the emission as the payload,
+// and all the slots are plain add() slots (one-shot, filtered or permanent ones included).
+//
+// fastsignal_replay TRACE [--iterations N]
+
+struct Payload
+{
+    const uint8_t *data;
+    uint32_t size;
+};
+
+using Signature = void(const Payload&);
+
+// One per recorded slot, reads the payload like a slot would use the arguments
+struct ReplayObserver
+{
+    uint64_t checksum = 0;
+
+    void on_event(const Payload &payload) {
+        checksum += payload.size + 1;
+        for (uint32_t i = 0; i < payload.size; i++)
+            checksum = checksum * 31 + payload.data[i];
+    }
+};
+
+struct Op
+{
+    record::EventType type;
+    uint32_t signal;
+    uint32_t slot;
+    Payload payload;
+};
+
+struct Trace
+{
+    std::vector<record::Event> events;
+    std::vector<Op> ops;
+    uint32_t signal_count = 0;
+    uint32_t slot_count = 0;
+    size_t emissions = 0;
+};
+
+struct FastSignalBackend
+{
+    static constexpr const char *name = "FastSignal";
+
+    std::vector<std::unique_ptr<FastSignal<Signature>>> signals;
+    std::vector<ConnectionView> connections;
+
+    FastSignalBackend(const Trace &trace) : signals(trace.signal_count), connections(trace.slot_count) {
+        for (auto &sig : signals)
+            sig = std::make_unique<FastSignal<Signature>>();
+    }
+
+    void connect(uint32_t signal, uint32_t slot, ReplayObserver *observer) {
+        connections[slot] = signals[signal]->add<&ReplayObserver::on_event>(observer);
+    }
+
+    void disconnect(uint32_t, uint32_t slot) {
+        connections[slot].disconnect();
+    }
+
+    void emit(uint32_t signal, const Payload &payload) {
+        (*signals[signal])(payload);
+    }
+
+    // The signal's slots are gone with it, the trace doesn't refer to them again
+    void destroy(uint32_t signal, const std::vector<uint32_t>&) {
+        signals[signal].reset();
+    }
+};
+
+struct FtengBackend
+{
+    static constexpr const char *name = "fteng::signal";
+
+    using Connection = decltype(std::declval<fteng::signal<Signature>&>().connect<&ReplayObserver::on_event>(
+        std::declval<ReplayObserver*>()));
+
+    std::vector<std::unique_ptr<fteng::signal<Signature>>> signals;
+    std::vector<std::optional<Connection>> connections;
+
+    FtengBackend(const Trace &trace) : signals(trace.signal_count), connections(trace.slot_count) {
+        for (auto &sig : signals)
+            sig = std::make_unique<fteng::signal<Signature>>();
+    }
+
+    void connect(uint32_t signal, uint32_t slot, ReplayObserver *observer) {
+        connections[slot].emplace(signals[signal]->connect<&ReplayObserver::on_event>(observer));
+    }
+
+    void disconnect(uint32_t, uint32_t slot) {
+        connections[slot]->disconnect();
+        connections[slot].reset();
+    }
+
+    void emit(uint32_t signal, const Payload &payload) {
+        (*signals[signal])(payload);
+    }
+
+    void destroy(uint32_t signal, const std::vector<uint32_t> &slots) {
+        for (uint32_t slot : slots) {
+            if (connections[slot]) {
+                connections[slot]->disconnect();
+                connections[slot].reset();
+            }
+        }
+        signals[signal].reset();
+    }
+};
+
+static bool load(const std::string &path, Trace &trace)
+{
+    if (!record::read(path, trace.events))
+        return false;
+
+    for (const record::Event &event : trace.events) {
+        trace.signal_count = std::max(trace.signal_count, event.signal + 1);
+        if (event.type == record::EventType::connect)
+            trace.slot_count = std::max(trace.slot_count, event.slot + 1);
+        if (event.type == record::EventType::emit)
+            ++trace.emissions;
+
+        Payload payload{event.args.data(), static_cast<uint32_t>(event.args.size())};
+        trace.ops.push_back({event.type, event.signal, event.slot, payload});
+    }
+    return true;
+}
+
+// Runs the trace once, returns the time it took and the observers' checksum
+template<typename Backend>
+static std::chrono::nanoseconds run(const Trace &trace, uint64_t &checksum)
+{
+    std::vector<ReplayObserver> observers(trace.slot_count);
+    // The slots connected to each signal, for the backends that have to disconnect them on destruction
+    std::vector<std::vector<uint32_t>> signal_slots(trace.signal_count);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        Backend backend(trace);
+        for (const Op &op : trace.ops) {
+            switch (op.type) {
+            case record::EventType::connect:
+                backend.connect(op.signal, op.slot, &observers[op.slot]);
+                signal_slots[op.signal].push_back(op.slot);
+                break;
+            case record::EventType::disconnect:
+                backend.disconnect(op.signal, op.slot);
+                break;
+            case record::EventType::emit:
+                backend.emit(op.signal, op.payload);
+                break;
+            case record::EventType::destroy:
+                backend.destroy(op.signal, signal_slots[op.signal]);
+                break;
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    checksum = 0;
+    for (const ReplayObserver &observer : observers)
+        checksum += observer.checksum;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+}
+
+template<typename Backend>
+static uint64_t replay(const Trace &trace, int iterations)
+{
+    uint64_t checksum = 0;
+    // Warm-up
+    run<Backend>(trace, checksum);
+
+    std::vector<double> times;
+    for (int i = 0; i < iterations; i++) {
+        uint64_t run_checksum = 0;
+        times.push_back(static_cast<double>(run<Backend>(trace, run_checksum).count()));
+        if (run_checksum != checksum) {
+            std::printf("%-16s not deterministic, checksum %llx then %llx\n", Backend::name,
+                static_cast<unsigned long long>(checksum), static_cast<unsigned long long>(run_checksum));
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+    std::printf("%-16s median %12.0f ns  %8.2f ns/emission  checksum %016llx\n", Backend::name, median,
+        trace.emissions ? median / trace.emissions : 0.0, static_cast<unsigned long long>(checksum));
+    return checksum;
+}
+
+int main(int argc, char **argv)
+{
+    std::string path;
+    int iterations = 21;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (path.empty() && arg.rfind("--", 0) != 0) {
+            path = arg;
+        } else {
+            std::cerr << "Usage: fastsignal_replay TRACE [--iterations N]\n";
+            return 2;
+        }
+    }
+
+    if (path.empty()) {
+        std::cerr << "Usage: fastsignal_replay TRACE [--iterations N]\n";
+        return 2;
+    }
+
+    Trace trace;
+    if (!load(path, trace)) {
+        std::cerr << "Can't read the trace " << path << "\n";
+        return 2;
+    }
+
+    std::printf("%s: %zu events, %u signals, %u slots, %zu emissions\n", path.c_str(), trace.events.size(),
+        trace.signal_count, trace.slot_count, trace.emissions);
+
+    uint64_t fastsignal_checksum = replay<FastSignalBackend>(trace, iterations);
+    uint64_t fteng_checksum = replay<FtengBackend>(trace, iterations);
+    if (fastsignal_checksum != fteng_checksum) {
+        std::printf("The backends called different slots\n");
+        return 1;
+    }
+    return 0;
+}
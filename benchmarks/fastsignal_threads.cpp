@@ -0,0 +1,252 @@
+#include <cstdio>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastsignal.hpp"
+
+using namespace fastsignal;
+
+// Emission throughput with several threads, each emitting its own signal or all emitting a shared one,
+// and connect/disconnect throughput on a shared signal, mutex-guarded or sharded.
+// items_per_second is the aggregate number of emissions (connect/disconnect pairs) of all the threads.
+
+constexpr size_t CACHE_LINE = 64;
+constexpr int SLOTS_PER_SIGNAL = 16;
+constexpr int MAX_THREADS = 16;
+
+struct Counter
+{
+    uint64_t calls = 0;
+
+    void handler() { ++calls; }
+};
+
+struct alignas(CACHE_LINE) PaddedCounter
+{
+    uint64_t calls = 0;
+
+    void handler() { ++calls; }
+};
+
+struct alignas(CACHE_LINE) PaddedSignal
+{
+    FastSignal<void()> sig;
+};
+
+// Every thread emits its own signal, slots write to their own cache lines.
+// Signals and counters are padded, nothing is shared between the threads.
+struct PaddedEmitters
+{
+    std::vector<PaddedSignal> signals{MAX_THREADS};
+    std::vector<PaddedCounter> counters{MAX_THREADS * SLOTS_PER_SIGNAL};
+
+    PaddedEmitters() {
+        for (int t = 0; t < MAX_THREADS; t++) {
+            for (int i = 0; i < SLOTS_PER_SIGNAL; i++)
+                signals[t].sig.add<&PaddedCounter::handler>(&counters[t * SLOTS_PER_SIGNAL + i]);
+        }
+    }
+};
+
+// Every thread emits its own signal, the signals are next to each other in memory.
+// An emission only reads the signal, so adjacent signals should cost nothing more than padded ones.
+struct AdjacentEmitters
+{
+    std::vector<FastSignal<void()>> signals{MAX_THREADS};
+    std::vector<PaddedCounter> counters{MAX_THREADS * SLOTS_PER_SIGNAL};
+
+    AdjacentEmitters() {
+        for (int t = 0; t < MAX_THREADS; t++) {
+            for (int i = 0; i < SLOTS_PER_SIGNAL; i++)
+                signals[t].add<&PaddedCounter::handler>(&counters[t * SLOTS_PER_SIGNAL + i]);
+        }
+    }
+};
+
+// Every thread emits its own signal, but the slots of different threads write to interleaved counters.
+// The reference for what false sharing costs: the writes, not the signals, share cache lines.
+struct FalseSharingEmitters
+{
+    std::vector<PaddedSignal> signals{MAX_THREADS};
+    std::vector<Counter> counters{MAX_THREADS * SLOTS_PER_SIGNAL};
+
+    FalseSharingEmitters() {
+        for (int t = 0; t < MAX_THREADS; t++) {
+            for (int i = 0; i < SLOTS_PER_SIGNAL; i++)
+                signals[t].sig.add<&Counter::handler>(&counters[i * MAX_THREADS + t]);
+        }
+    }
+};
+
+// One signal emitted by all the threads, synchronized by the caller as the signal isn't thread-safe
+struct SharedEmitter
+{
+    std::mutex mutex;
+    FastSignal<void()> sig;
+    std::vector<PaddedCounter> counters{SLOTS_PER_SIGNAL};
+
+    SharedEmitter() {
+        for (auto &counter : counters)
+            sig.add<&PaddedCounter::handler>(&counter);
+    }
+};
+
+template<typename Emitters>
+static Emitters& emitters()
+{
+    static Emitters emitters;
+    return emitters;
+}
+
+static void BM_threads_padded(benchmark::State& state)
+{
+    auto &sig = emitters<PaddedEmitters>().signals[state.thread_index()].sig;
+    for (auto _ : state)
+        sig();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_padded)->Name("threads(own signal, padded)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_threads_adjacent(benchmark::State& state)
+{
+    auto &sig = emitters<AdjacentEmitters>().signals[state.thread_index()];
+    for (auto _ : state)
+        sig();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_adjacent)->Name("threads(own signal, adjacent)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_threads_false_sharing(benchmark::State& state)
+{
+    auto &sig = emitters<FalseSharingEmitters>().signals[state.thread_index()].sig;
+    for (auto _ : state)
+        sig();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_false_sharing)->Name("threads(own signal, false sharing slots)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_threads_shared(benchmark::State& state)
+{
+    auto &shared = emitters<SharedEmitter>();
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.sig();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_shared)->Name("threads(shared signal, mutex)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// Connect and disconnect heavy: every thread connects a listener to a global signal and disconnects it,
+// emitting the signal every EMIT_PERIOD connections. The signal has SLOTS_PER_SIGNAL long-lived slots.
+// items_per_second is the aggregate number of connect/disconnect pairs.
+constexpr int EMIT_PERIOD = 64;
+
+// A FastSignal under a mutex, every connect, disconnect and emission takes the same lock
+struct MutexListeners
+{
+    std::mutex mutex;
+    FastSignal<void()> sig;
+    std::vector<PaddedCounter> counters{SLOTS_PER_SIGNAL};
+
+    MutexListeners() {
+        for (auto &counter : counters)
+            sig.add<&PaddedCounter::handler>(&counter);
+    }
+};
+
+// A ShardedSignal with a shard per thread, connect and disconnect only lock the thread's shard
+struct ShardedListeners
+{
+    ShardedSignal<void()> sig{MAX_THREADS};
+    std::vector<PaddedCounter> counters{SLOTS_PER_SIGNAL};
+
+    ShardedListeners() {
+        for (auto &counter : counters)
+            sig.add<&PaddedCounter::handler>(&counter);
+    }
+};
+
+static void BM_threads_connect_mutex(benchmark::State& state)
+{
+    auto &listeners = emitters<MutexListeners>();
+    PaddedCounter listener;
+    int connections = 0;
+    for (auto _ : state) {
+        ConnectionView connection;
+        {
+            std::lock_guard<std::mutex> lock(listeners.mutex);
+            connection = listeners.sig.add<&PaddedCounter::handler>(&listener);
+        }
+        {
+            std::lock_guard<std::mutex> lock(listeners.mutex);
+            connection.disconnect();
+        }
+        if (++connections % EMIT_PERIOD == 0) {
+            std::lock_guard<std::mutex> lock(listeners.mutex);
+            listeners.sig();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_connect_mutex)->Name("threads(connect/disconnect, mutex)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_threads_connect_sharded(benchmark::State& state)
+{
+    auto &listeners = emitters<ShardedListeners>();
+    PaddedCounter listener;
+    int connections = 0;
+    for (auto _ : state) {
+        ShardedConnection connection = listeners.sig.add<&PaddedCounter::handler>(&listener);
+        connection.disconnect();
+        if (++connections % EMIT_PERIOD == 0)
+            listeners.sig();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_threads_connect_sharded)->Name("threads(connect/disconnect, sharded)")->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// Where the members of FastSignalBase fall in cache lines, and which of them an emission writes
+struct LayoutProbe : internal::FastSignalBase
+{
+    template<typename Member>
+    void print(const char *name, const Member &member, const char *access) const {
+        size_t offset = reinterpret_cast<const char*>(&member) - reinterpret_cast<const char*>(this);
+        std::printf("  %-16s offset %3zu  size %3zu  line %zu  %s\n", name, offset, sizeof(Member),
+            offset / CACHE_LINE, access);
+    }
+
+    void print() const {
+        std::printf("FastSignalBase: %zu bytes, %zu cache line(s)\n", sizeof(internal::FastSignalBase),
+            (sizeof(internal::FastSignalBase) + CACHE_LINE - 1) / CACHE_LINE);
+        print("is_dirty", is_dirty, "read by every emission, written when compacting");
+        print("blocked", blocked, "read by every emission");
+        print("lists_dirty", lists_dirty, "read by every emission, written when compacting");
+        print("is_emitting_once", is_emitting_once, "written by emissions with one-shot slots");
+        print("once_list", once_list, "read by every emission");
+        print("extension", extension, "read by every emission, the state of filtered, one-shot and add_on slots");
+        print("callbacks", callbacks, "read by every emission");
+        print("live.dead", live.dead, "read by every emission");
+        print("live.words", live.words, "read by emissions over dead slots");
+        print("callback_count", callback_count, "written on connect and disconnect");
+        print("anchor", anchor, "written on the first connect and on moves");
+        std::printf("FastSignal<void()>: %zu bytes, FastSignal<void(int)>: %zu bytes\n\n",
+            sizeof(FastSignal<void()>), sizeof(FastSignal<void(int)>));
+    }
+};
+
+int main(int argc, char **argv)
+{
+    LayoutProbe().print();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
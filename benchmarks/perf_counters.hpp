@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread through Linux perf_event_open.
+// Counters the kernel or the CPU don't provide are reported as unavailable, nothing else changes.
+enum class PerfEvent
+{
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_misses,
+    llc_misses,
+    count
+};
+
+inline const char* perf_event_name(PerfEvent event)
+{
+    switch (event) {
+    case PerfEvent::cycles: return "cycles";
+    case PerfEvent::instructions: return "instructions";
+    case PerfEvent::branch_misses: return "branch_misses";
+    case PerfEvent::l1d_misses: return "l1d_misses";
+    case PerfEvent::llc_misses: return "llc_misses";
+    default: return "";
+    }
+}
+
+class PerfCounters
+{
+    static constexpr size_t EVENT_COUNT = static_cast<size_t>(PerfEvent::count);
+
+    std::array<int, EVENT_COUNT> fds;
+    std::array<uint64_t, EVENT_COUNT> values{};
+
+#ifdef __linux__
+    static int open_counter(uint32_t type, uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // The counters can be multiplexed when the CPU has too few of them, the values are scaled back in stop()
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+        fds.fill(-1);
+#ifdef __linux__
+        constexpr uint64_t l1d_read_misses = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        fds[static_cast<size_t>(PerfEvent::cycles)] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[static_cast<size_t>(PerfEvent::instructions)] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[static_cast<size_t>(PerfEvent::branch_misses)] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[static_cast<size_t>(PerfEvent::l1d_misses)] = open_counter(PERF_TYPE_HW_CACHE, l1d_read_misses);
+        fds[static_cast<size_t>(PerfEvent::llc_misses)] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    bool any_available() const {
+        for (int fd : fds) {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool available(PerfEvent event) const {
+        return fds[static_cast<size_t>(event)] >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0)
+                continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        for (size_t i = 0; i < EVENT_COUNT; i++) {
+            if (fds[i] < 0)
+                continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            // value, time enabled, time running
+            uint64_t data[3];
+            if (read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+                values[i] = 0;
+            else if (data[2] < data[1])
+                values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+            else
+                values[i] = data[0];
+        }
+#endif
+    }
+
+    // Counted between the last start() and stop()
+    uint64_t value(PerfEvent event) const {
+        return values[static_cast<size_t>(event)];
+    }
+};
@@ -1,13 +1,71 @@
 #pragma once
 
+#include <array>
 #include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <optional>
+#include <algorithm>
+#include <utility>
 #include <functional>
+#include <memory_resource>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef FASTSIGNAL_TRACE
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+
+#define FASTSIGNAL_TRACE_EMISSION(signal) ::fastsignal::trace::Span fastsignal_emission_span(signal)
+#define FASTSIGNAL_TRACE_SLOT(slot) ::fastsignal::trace::SlotSpan fastsignal_slot_span(slot)
+#else
+#define FASTSIGNAL_TRACE_EMISSION(signal) (void)0
+#define FASTSIGNAL_TRACE_SLOT(slot) (void)0
+#endif
+
+#ifdef FASTSIGNAL_STATS
+#define FASTSIGNAL_STATS_ADD(counter, value) \
+    ::fastsignal::stats::counters().counter.fetch_add(value, std::memory_order_relaxed)
+#else
+#define FASTSIGNAL_STATS_ADD(counter, value) (void)0
+#endif
+
+#ifdef FASTSIGNAL_RECORD
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#define FASTSIGNAL_RECORD_CONNECT(anchor, conn) ::fastsignal::record::on_connect(anchor, conn)
+#define FASTSIGNAL_RECORD_DISCONNECT(anchor, conn) ::fastsignal::record::on_disconnect(anchor, conn)
+#define FASTSIGNAL_RECORD_DESTROY(anchor) ::fastsignal::record::on_destroy(anchor)
+#define FASTSIGNAL_RECORD_EMISSION(anchor, args) ::fastsignal::record::on_emit<ArgTypes...>(anchor, args...)
+#else
+#define FASTSIGNAL_RECORD_CONNECT(anchor, conn) (void)0
+#define FASTSIGNAL_RECORD_DISCONNECT(anchor, conn) (void)0
+#define FASTSIGNAL_RECORD_DESTROY(anchor) (void)0
+#define FASTSIGNAL_RECORD_EMISSION(anchor, args) (void)0
+#endif
 
 namespace fastsignal {
 
 namespace internal {
     struct Callback;
     struct Connection;
+    struct SignalAnchor;
     class FastSignalBase;
 } // namespace internal
 
@@ -15,290 +73,2958 @@ class Disconnectable;
 class ConnectionView;
 template<typename Signature>
 class FastSignal;
+template<size_t N>
+class SignalBlocker;
+template<typename Signature>
+class EventBus;
+template<typename... Events>
+class TypedEventBus;
+class CoalescingGroup;
+template<typename Signature>
+class CoalescingSignal;
+template<auto... funs, class ObjType, typename... Signals>
+ConnectionView connect_all(ObjType *obj, Signals&... signals);
+
+// What a signal or a Disconnectable holds, see memory_usage()
+struct MemoryUsage
+{
+    // Connected slots, blocked ones included. The live connections of a Disconnectable.
+    size_t slots = 0;
+    // Disconnected slots kept until the next compaction.
+    // The expired connections of a Disconnectable, they keep their connection record allocated.
+    size_t tombstones = 0;
+    // Slots (connections) the arrays can hold without growing
+    size_t capacity = 0;
+    // Bytes allocated from the memory resource, the connection records included
+    size_t heap_bytes = 0;
+};
+
+#ifdef FASTSIGNAL_STATS
+// Totals of all the signals of the process, compiled in with FASTSIGNAL_STATS only.
+// The counters are updated with relaxed atomics, snapshot() can be called from any thread.
+namespace stats {
+
+struct Snapshot
+{
+    // Signals alive, moved-from ones included
+    int64_t signals = 0;
+    // Connected slots, blocked ones included
+    int64_t slots = 0;
+    // Disconnected slots kept until the next compaction
+    int64_t tombstones = 0;
+    // Slot lists compacted, and tombstones removed by them
+    int64_t compactions = 0;
+    int64_t reclaimed = 0;
+};
+
+struct Counters
+{
+    std::atomic<int64_t> signals{0};
+    std::atomic<int64_t> slots{0};
+    std::atomic<int64_t> tombstones{0};
+    std::atomic<int64_t> compactions{0};
+    std::atomic<int64_t> reclaimed{0};
+};
+
+inline Counters& counters() {
+    static Counters counters;
+    return counters;
+}
+
+inline Snapshot snapshot() {
+    Counters &c = counters();
+    Snapshot snapshot;
+    snapshot.signals = c.signals.load(std::memory_order_relaxed);
+    snapshot.slots = c.slots.load(std::memory_order_relaxed);
+    snapshot.tombstones = c.tombstones.load(std::memory_order_relaxed);
+    snapshot.compactions = c.compactions.load(std::memory_order_relaxed);
+    snapshot.reclaimed = c.reclaimed.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace stats
+#endif
+
+#ifdef FASTSIGNAL_RECORD
+// Log of the connections, disconnections and emissions of all the signals, compiled in with FASTSIGNAL_RECORD only.
+// Recording runs between start() and stop(), write() saves the log to a compact binary file that read() loads back,
+// for the fastsignal_replay benchmark. Signals and slots are numbered in the order they are first seen,
+// only the slots connected while recording are known. An emission saves its arguments converted to the signal's
+// trivially copyable parameter types, in the byte order of the machine. Outside of start() and stop(),
+// the hooks cost an atomic load, while recording they take a lock.
+namespace record {
+
+enum class EventType : uint8_t
+{
+    connect,
+    disconnect,
+    emit,
+    // The signal was destroyed, its number isn't reused
+    destroy,
+};
+
+struct Event
+{
+    EventType type;
+    uint32_t signal = 0;
+    // connect and disconnect only
+    uint32_t slot = 0;
+    // emit only
+    std::vector<uint8_t> args;
+};
+
+constexpr char MAGIC[8] = {'F', 'S', 'R', 'E', 'C', '0', '0', '1'};
+
+struct Recorder
+{
+    std::mutex mutex;
+    std::atomic<bool> enabled{false};
+    std::vector<uint8_t> data;
+    // By anchor, which doesn't change when the signal is moved
+    std::unordered_map<const void*, uint32_t> signals;
+    // By connection, permanent slots have none and can't be disconnected
+    std::unordered_map<const void*, uint32_t> slots;
+    uint32_t signal_count = 0;
+    uint32_t slot_count = 0;
+
+    uint32_t signal_id(const void *anchor) {
+        auto [it, inserted] = signals.try_emplace(anchor, signal_count);
+        if (inserted)
+            ++signal_count;
+        return it->second;
+    }
+
+    void put(const void *bytes, size_t size) {
+        data.insert(data.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+    }
+
+    template<typename T>
+    void put(T value) {
+        put(&value, sizeof(value));
+    }
+};
+
+inline Recorder& recorder() {
+    static Recorder recorder;
+    return recorder;
+}
+
+inline bool is_recording() {
+    return recorder().enabled.load(std::memory_order_relaxed);
+}
+
+// Starts a new log, the previous one is dropped
+inline void start() {
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.data.clear();
+    r.signals.clear();
+    r.slots.clear();
+    r.signal_count = 0;
+    r.slot_count = 0;
+    r.enabled.store(true, std::memory_order_relaxed);
+}
+
+inline void stop() {
+    recorder().enabled.store(false, std::memory_order_relaxed);
+}
+
+inline void on_connect(const void *anchor, const void *conn) {
+    if (!is_recording())
+        return;
+
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint32_t slot = r.slot_count++;
+    if (conn)
+        r.slots[conn] = slot;
+    r.put(EventType::connect);
+    r.put(r.signal_id(anchor));
+    r.put(slot);
+}
+
+inline void on_disconnect(const void *anchor, const void *conn) {
+    if (!is_recording())
+        return;
+
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.slots.find(conn);
+    if (it == r.slots.end())
+        return;
+    r.put(EventType::disconnect);
+    r.put(r.signal_id(anchor));
+    r.put(it->second);
+    r.slots.erase(it);
+}
+
+inline void on_destroy(const void *anchor) {
+    if (!is_recording())
+        return;
+
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.signals.find(anchor);
+    if (it == r.signals.end())
+        return;
+    r.put(EventType::destroy);
+    r.put(it->second);
+    r.signals.erase(it);
+}
+
+// Declared are the parameter types of the signal, which decide what is saved, not the types of the arguments
+template<typename... Declared, typename... Actual>
+void on_emit(const void *anchor, const Actual&... args) {
+    // A signal without an anchor was never connected
+    if (!anchor || !is_recording())
+        return;
+
+    constexpr uint32_t size = (0 + ... + (std::is_trivially_copyable_v<std::decay_t<Declared>> ?
+        sizeof(std::decay_t<Declared>) : 0));
+
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.put(EventType::emit);
+    r.put(r.signal_id(anchor));
+    r.put(size);
+    ([&r](const auto &arg) {
+        using Type = std::decay_t<Declared>;
+        if constexpr (std::is_trivially_copyable_v<Type>) {
+            Type value = arg;
+            r.put(&value, sizeof(value));
+        }
+    }(args), ...);
+}
+
+inline bool write(std::ostream &out) {
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(r.data.data()), r.data.size());
+    return static_cast<bool>(out);
+}
+
+inline bool write(const std::string &path) {
+    std::ofstream out(path, std::ios::binary);
+    return out && write(out);
+}
+
+// Returns false if the file isn't a complete log
+inline bool read(std::istream &in, std::vector<Event> &events) {
+    auto get = [&in](auto &value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    };
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    events.clear();
+    EventType type;
+    while (get(type)) {
+        Event &event = events.emplace_back();
+        event.type = type;
+        if (!get(event.signal))
+            return false;
+
+        switch (type) {
+        case EventType::connect:
+        case EventType::disconnect:
+            if (!get(event.slot))
+                return false;
+            break;
+        case EventType::emit: {
+            uint32_t size;
+            if (!get(size))
+                return false;
+            event.args.resize(size);
+            if (size && !in.read(reinterpret_cast<char*>(event.args.data()), size))
+                return false;
+            break;
+        }
+        case EventType::destroy:
+            break;
+        default:
+            return false;
+        }
+    }
+    return in.eof();
+}
+
+inline bool read(const std::string &path, std::vector<Event> &events) {
+    std::ifstream in(path, std::ios::binary);
+    return in && read(in, events);
+}
+
+} // namespace record
+#endif
+template<typename... Signatures>
+class SignalGroup;
+class EventLoop;
+template<typename Signature, size_t Capacity = 1024>
+class SpscSignal;
+template<typename Signature>
+class ShardedSignal;
+
+namespace internal {
+
+struct Callback
+{
+    void *obj = nullptr;
+    void *fun = nullptr;
+    std::shared_ptr<Connection> conn = nullptr;
+};
+
+// The stable identity of a signal. Connections point to the anchor instead of the signal,
+// a moved signal takes the anchor with it and only the anchor is updated.
+struct SignalAnchor
+{
+    FastSignalBase *sig = nullptr;
+    // The resource the anchor was allocated from, the signal's resource may change on move assignment
+    std::pmr::memory_resource *mr = nullptr;
+    // Chains the anchors released in a TeardownScope, see FastSignalBase::release_all()
+    SignalAnchor *next = nullptr;
+};
+
+inline void free_anchor(SignalAnchor *anchor)
+{
+    std::pmr::polymorphic_allocator<SignalAnchor> alloc(anchor->mr);
+    alloc.deallocate(anchor, 1);
+}
+
+struct Connection
+{
+    // nullptr once disconnected or when the signal is destroyed
+    SignalAnchor *anchor = nullptr;
+    // The slot's function while it is blocked, nullptr otherwise
+    void *blocked_fun = nullptr;
+    int index = -1;
+    // The connections of connect_all() share a record, the first one holds their number and stands for all of them
+    int record_count = 1;
+    // The slot list of the signal holding the slot, 0 is the main list
+    uint32_t list = 0;
+    bool is_disconnectable = false;
+    // Allocated together with the other connections of an add_range(), see FastSignalBase::make_connections()
+    bool in_block = false;
+    // Cleared with anchor, can be read from the threads of the event loops the slot is delivered on
+    std::atomic<bool> is_connected{true};
+
+    Connection() = default;
+
+    Connection(SignalAnchor *anchor, int index, bool is_disconnectable, uint32_t list = 0) :
+        anchor(anchor), index(index), list(list), is_disconnectable(is_disconnectable) {}
+
+    Connection(const Connection &other) = delete;
+    Connection &operator=(const Connection &other) = delete;
+    Connection(Connection &&other) = delete;
+    Connection &operator=(Connection &&other) = delete;
+
+    void detach() {
+        anchor = nullptr;
+        is_connected.store(false, std::memory_order_release);
+    }
+
+    // The signal holding the slot, nullptr once disconnected or when the signal was destroyed in a TeardownScope
+    FastSignalBase* signal() const {
+        return anchor ? anchor->sig : nullptr;
+    }
+
+    // Still connected to one of its signals at least
+    bool is_attached() const {
+        for (const Connection *conn = this; conn != this + record_count; ++conn) {
+            if (conn->signal())
+                return true;
+        }
+        return false;
+    }
+
+    inline void disconnect();
+    inline void block();
+    inline void unblock();
+    inline void update_sig_obj(Disconnectable *obj);
+
+    inline void disconnect_slot();
+    inline void block_slot();
+    inline void unblock_slot();
+};
+
+inline void prefetch(const void *address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+inline unsigned count_trailing_zeros(uint64_t word)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// The objects of a TeardownScope being destroyed on the thread
+struct Teardown
+{
+    // Anchors of the signals destroyed so far, the connections of the other objects may still point to them
+    SignalAnchor *released = nullptr;
+};
+
+// nullptr outside of TeardownScope::~TeardownScope()
+inline Teardown*& current_teardown()
+{
+    thread_local Teardown *teardown = nullptr;
+    return teardown;
+}
+
+// Bytes allocated by FastSignalBase::make_connection() for one connection, the shared_ptr control block included.
+// Measured once, the layout of the control block is up to the standard library.
+inline size_t connection_record_bytes()
+{
+    struct CountingResource : std::pmr::memory_resource
+    {
+        size_t bytes = 0;
+
+        void *do_allocate(size_t size, size_t alignment) override {
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+
+        void do_deallocate(void *p, size_t size, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    static const size_t bytes = []() {
+        CountingResource counting;
+        std::pmr::polymorphic_allocator<Callback> alloc(&counting);
+        std::allocate_shared<Connection>(alloc, nullptr, 0, false);
+        return counting.bytes;
+    }();
+    return bytes;
+}
+
+// One bit per slot, set while the slot has a function (not disconnected, not blocked).
+// An emission over a list with dead slots tests 64 slots at a time instead of reading every callback.
+struct LiveSlots
+{
+    static constexpr size_t WORD_BITS = 64;
+
+    // Before the words, next to the main slot list of the signal in the same cache line
+    size_t dead = 0;
+    std::pmr::vector<uint64_t> words;
+
+    LiveSlots() = default;
+    explicit LiveSlots(std::pmr::memory_resource *mr) : words(mr) {}
+
+    LiveSlots(const LiveSlots&) = default;
+    LiveSlots& operator=(const LiveSlots&) = default;
+
+    LiveSlots(LiveSlots &&other) noexcept : dead(std::exchange(other.dead, 0)), words(std::move(other.words)) {}
+
+    LiveSlots& operator=(LiveSlots &&other) {
+        words = std::move(other.words);
+        other.words.clear();
+        dead = std::exchange(other.dead, 0);
+        return *this;
+    }
+
+    void push(size_t index) {
+        if (index % WORD_BITS == 0)
+            words.push_back(0);
+        words[index / WORD_BITS] |= uint64_t(1) << (index % WORD_BITS);
+    }
+
+    void kill(size_t index) {
+        uint64_t &word = words[index / WORD_BITS];
+        uint64_t bit = uint64_t(1) << (index % WORD_BITS);
+        if (!(word & bit))
+            return;
+        word &= ~bit;
+        ++dead;
+    }
+
+    void revive(size_t index) {
+        uint64_t &word = words[index / WORD_BITS];
+        uint64_t bit = uint64_t(1) << (index % WORD_BITS);
+        if (word & bit)
+            return;
+        word |= bit;
+        --dead;
+    }
+
+    // Index of the first dead slot, size if there is none
+    size_t first_dead(size_t size) const {
+        if (!dead)
+            return size;
+
+        for (size_t w = 0; w < words.size(); ++w) {
+            if (~words[w])
+                return std::min(size, w * WORD_BITS + count_trailing_zeros(~words[w]));
+        }
+        return size;
+    }
+
+    // Recomputes the bits from index on, after the slots there were moved
+    void reset(const std::pmr::vector<Callback> &list, size_t index) {
+        words.resize((list.size() + WORD_BITS - 1) / WORD_BITS);
+        if (index / WORD_BITS < words.size())
+            words[index / WORD_BITS] &= (uint64_t(1) << (index % WORD_BITS)) - 1;
+        std::fill(words.begin() + std::min(words.size(), index / WORD_BITS + 1), words.end(), 0);
+
+        // The slots before index were all live
+        dead = 0;
+        for (size_t i = index; i < list.size(); i++) {
+            if (list[i].fun)
+                words[i / WORD_BITS] |= uint64_t(1) << (i % WORD_BITS);
+            else
+                ++dead;
+        }
+    }
+};
+
+// Slots that are not part of the main list (e.g. filtered slots), emitted separately by the signal.
+// Allocated one by one, a slot list doesn't move when a slot adds another list during an emission.
+struct SlotList
+{
+    std::pmr::vector<Callback> callbacks;
+    LiveSlots live;
+    bool is_dirty = false;
+
+    explicit SlotList(std::pmr::memory_resource *mr) : callbacks(mr), live(mr) {}
+
+    static SlotList* make(std::pmr::memory_resource *mr) {
+        std::pmr::polymorphic_allocator<SlotList> alloc(mr);
+        return new (alloc.allocate(1)) SlotList(mr);
+    }
+
+    // With the resource it was allocated from, a moved signal may hold the lists of another resource
+    static void destroy(SlotList *slot_list) {
+        std::pmr::polymorphic_allocator<SlotList> alloc(slot_list->callbacks.get_allocator().resource());
+        slot_list->~SlotList();
+        alloc.deallocate(slot_list, 1);
+    }
+};
+
+// The state of the features most signals don't use (filtered slots, forwarding links...), allocated
+// by the first of them a signal uses. A signal without them only holds a null pointer.
+// Never moves once allocated, the signal's derived class adds the indexes of its features.
+struct SignalExtension
+{
+    std::pmr::vector<SlotList*> slot_lists;
+
+    explicit SignalExtension(std::pmr::memory_resource *mr) : slot_lists(mr) {}
+
+    SignalExtension(const SignalExtension&) = delete;
+    SignalExtension& operator=(const SignalExtension&) = delete;
+
+    // Destroys and frees the extension with the resource it was allocated from
+    virtual void destroy() = 0;
+
+protected:
+    ~SignalExtension() {
+        for (SlotList *slot_list : slot_lists)
+            SlotList::destroy(slot_list);
+    }
+};
+
+class FastSignalBase
+{
+protected:
+    // Everything an emission of the main slot list reads fits in the first cache line: the flags, the extension,
+    // the callbacks and the dead slot count (see the layout printed by fastsignal_threads)
+    mutable bool is_dirty = false;
+    bool blocked = false;
+    mutable bool lists_dirty = false;
+    mutable bool is_emitting_once = false;
+    // One-shot slots, 0 until the first one is added
+    uint32_t once_list = 0;
+    // nullptr until the signal uses one of the features of its extension
+    SignalExtension *extension = nullptr;
+
+    mutable std::pmr::vector<Callback> callbacks;
+    mutable LiveSlots live;
+
+    mutable size_t callback_count = 0;
+
+    // list > 0 only, the signal has an extension
+    SlotList& slot_list(uint32_t list) const {
+        return *extension->slot_lists[list - 1];
+    }
+
+    std::pmr::vector<Callback>& slots(uint32_t list) const {
+        return list == 0 ? callbacks : slot_list(list).callbacks;
+    }
+
+    LiveSlots& live_slots(uint32_t list) const {
+        return list == 0 ? live : slot_list(list).live;
+    }
+
+    void push_slot(uint32_t list, const Callback &cb) {
+        auto &list_slots = slots(list);
+        live_slots(list).push(list_slots.size());
+        list_slots.push_back(cb);
+        ++callback_count;
+        FASTSIGNAL_STATS_ADD(slots, 1);
+        FASTSIGNAL_RECORD_CONNECT(get_anchor(), cb.conn.get());
+    }
+
+    // ext is the signal's extension, allocated by the derived class
+    uint32_t new_slot_list(SignalExtension &ext) {
+        ext.slot_lists.push_back(SlotList::make(resource()));
+        return ext.slot_lists.size();
+    }
+
+    void release_extension() {
+        if (!extension)
+            return;
+        extension->destroy();
+        extension = nullptr;
+    }
+
+    // Allocated with the first connection, signals that were never connected don't need one
+    SignalAnchor *anchor = nullptr;
+
+    SignalAnchor *get_anchor() {
+        if (!anchor) {
+            std::pmr::polymorphic_allocator<SignalAnchor> alloc(resource());
+            anchor = new (alloc.allocate(1)) SignalAnchor{this, resource()};
+        }
+        return anchor;
+    }
+
+    // Disconnects every slot and releases the anchor
+    void detach_all() {
+        for_each_callback([](Callback &cb) {
+            // Permanent slots have no connection
+            if (!cb.conn) {
+                FASTSIGNAL_STATS_ADD(slots, -1);
+                return;
+            }
+#ifdef FASTSIGNAL_STATS
+            if (cb.conn->anchor)
+                FASTSIGNAL_STATS_ADD(slots, -1);
+            else
+                FASTSIGNAL_STATS_ADD(tombstones, -1);
+#endif
+            cb.conn->detach();
+            cb.conn = nullptr;
+        });
+
+        release_anchor();
+    }
+
+    // Destruction inside a TeardownScope: the connections are left as they are, only the slots are released
+    void release_all() {
+#ifdef FASTSIGNAL_STATS
+        size_t size = 0;
+        for_each_list([&size](std::pmr::vector<Callback> &list, LiveSlots&) { size += list.size(); });
+        FASTSIGNAL_STATS_ADD(slots, -static_cast<int64_t>(callback_count));
+        FASTSIGNAL_STATS_ADD(tombstones, -static_cast<int64_t>(size - callback_count));
+#endif
+        if (!anchor)
+            return;
+        // Freed by the scope once all its objects are destroyed
+        FASTSIGNAL_RECORD_DESTROY(anchor);
+        Teardown *teardown = current_teardown();
+        anchor->sig = nullptr;
+        anchor->next = teardown->released;
+        teardown->released = anchor;
+        anchor = nullptr;
+    }
+
+    void release_anchor() {
+        if (!anchor)
+            return;
+        FASTSIGNAL_RECORD_DESTROY(anchor);
+        free_anchor(anchor);
+        anchor = nullptr;
+    }
+
+    // Connections are allocated from the same resource as the callbacks
+    std::shared_ptr<Connection> make_connection(bool is_disconnectable, uint32_t list = 0) {
+        return std::allocate_shared<Connection>(callbacks.get_allocator(), get_anchor(), slots(list).size(), is_disconnectable, list);
+    }
+
+    struct ConnectionBlockDeleter
+    {
+        std::pmr::memory_resource *mr;
+        size_t count;
+
+        void operator()(Connection *connections) const {
+            for (size_t i = 0; i < count; i++)
+                connections[i].~Connection();
+            std::pmr::polymorphic_allocator<Connection>(mr).deallocate(connections, count);
+        }
+    };
+
+    // The connections of the next count slots of list, in a single block.
+    // Returns the first one, the others are aliased to the same block with shared_ptr's aliasing constructor.
+    // The block is released with the last of its connections.
+    std::shared_ptr<Connection> make_connections(size_t count, bool is_disconnectable, uint32_t list = 0) {
+        std::pmr::polymorphic_allocator<Connection> alloc(resource());
+        Connection *connections = alloc.allocate(count);
+        size_t first = slots(list).size();
+        for (size_t i = 0; i < count; i++) {
+            new (connections + i) Connection(get_anchor(), first + i, is_disconnectable, list);
+            connections[i].in_block = true;
+        }
+        return std::shared_ptr<Connection>(connections, ConnectionBlockDeleter{resource(), count}, alloc);
+    }
+
+    // Grows the slot arrays of list geometrically, for count more slots
+    void reserve_slots(uint32_t list, size_t count) {
+        auto &list_slots = slots(list);
+        size_t size = list_slots.size() + count;
+        if (size <= list_slots.capacity())
+            return;
+
+        size = std::max(size, 2 * list_slots.capacity());
+        list_slots.reserve(size);
+        live_slots(list).words.reserve((size + LiveSlots::WORD_BITS - 1) / LiveSlots::WORD_BITS);
+    }
+
+    template<typename Fun>
+    void for_each_list(Fun &&fun) {
+        fun(callbacks, live);
+        if (!extension)
+            return;
+        for (SlotList *slot_list : extension->slot_lists)
+            fun(slot_list->callbacks, slot_list->live);
+    }
+
+    template<typename Fun>
+    void for_each_callback(Fun &&fun) {
+        for (auto &cb : callbacks)
+            fun(cb);
+        if (!extension)
+            return;
+        for (SlotList *slot_list : extension->slot_lists) {
+            for (auto &cb : slot_list->callbacks)
+                fun(cb);
+        }
+    }
+
+    static void compact(std::pmr::vector<Callback> &list, LiveSlots &live) {
+        // The slots before the first hole keep their place
+        size_t first = live.first_dead(list.size());
+        size_t size = first;
+        for (size_t i = first; i < list.size(); i++) {
+            // Permanent slots have no connection but are never dead
+            if (list[i].fun == nullptr && !list[i].conn->blocked_fun) {
+                list[i].conn->detach();
+                list[i].conn = nullptr;
+            } else {
+                if (size != i)
+                    list[size] = std::move(list[i]);
+                if (list[size].conn)
+                    list[size].conn->index = size;
+                size++;
+            }
+        }
+
+        FASTSIGNAL_STATS_ADD(compactions, 1);
+        FASTSIGNAL_STATS_ADD(tombstones, -static_cast<int64_t>(list.size() - size));
+        FASTSIGNAL_STATS_ADD(reclaimed, static_cast<int64_t>(list.size() - size));
+        list.resize(size);
+        live.reset(list, first);
+    }
+
+    void compact() const {
+        if (is_dirty) {
+            compact(callbacks, live);
+            is_dirty = false;
+        }
+
+        // A moved-from signal has no extension left
+        if (!lists_dirty || !extension)
+            return;
+
+        for (uint32_t list = 1; list <= extension->slot_lists.size(); ++list) {
+            SlotList &dirty_list = slot_list(list);
+            // The one-shot list is cleaned up by consume_once()
+            if (!dirty_list.is_dirty || list == once_list)
+                continue;
+            compact(dirty_list.callbacks, dirty_list.live);
+            dirty_list.is_dirty = false;
+        }
+        lists_dirty = false;
+    }
+
+    uint32_t once_slot_list(SignalExtension &ext) {
+        if (!once_list)
+            once_list = new_slot_list(ext);
+        return once_list;
+    }
+
+    // Drops the one-shot slots that were called or disconnected, both have no signal anymore.
+    // Blocked slots and slots added during the emission are kept.
+    void consume_once() const {
+        SlotList &once = slot_list(once_list);
+        auto &list = once.callbacks;
+        size_t size = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (!list[i].conn->anchor) {
+                list[i].conn = nullptr;
+            } else {
+                if (size != i)
+                    list[size] = std::move(list[i]);
+                list[size].conn->index = size;
+                size++;
+            }
+        }
+
+        FASTSIGNAL_STATS_ADD(tombstones, -static_cast<int64_t>(list.size() - size));
+        list.resize(size);
+        once.live.reset(list, 0);
+        once.is_dirty = false;
+    }
+
+    MemoryUsage base_memory_usage() const {
+        MemoryUsage usage;
+        size_t records = 0;
+        size_t block_records = 0;
+        auto add_list = [&](const std::pmr::vector<Callback> &list, const LiveSlots &list_live) {
+            usage.tombstones += list.size();
+            usage.capacity += list.capacity();
+            usage.heap_bytes += list.capacity() * sizeof(Callback) + list_live.words.capacity() * sizeof(uint64_t);
+            for (const Callback &cb : list) {
+                if (!cb.conn)
+                    continue;
+                if (cb.conn->in_block)
+                    ++block_records;
+                else
+                    ++records;
+            }
+        };
+
+        add_list(callbacks, live);
+        if (extension) {
+            // The extension itself is counted by the derived class
+            for (const SlotList *slot_list : extension->slot_lists)
+                add_list(slot_list->callbacks, slot_list->live);
+            usage.heap_bytes += extension->slot_lists.capacity() * sizeof(SlotList*) +
+                extension->slot_lists.size() * sizeof(SlotList);
+        }
+
+        usage.slots = callback_count;
+        usage.tombstones -= callback_count;
+        // The connections of a block are counted one by one, without the control block they share
+        usage.heap_bytes += records * connection_record_bytes() + block_records * sizeof(Connection);
+        if (anchor)
+            usage.heap_bytes += sizeof(SignalAnchor);
+        return usage;
+    }
+
+public:
+    FastSignalBase() {
+        FASTSIGNAL_STATS_ADD(signals, 1);
+    }
+
+    // All the signal's storage (callbacks and connections) is allocated from mr.
+    // mr must outlive the signal and any ConnectionView or Disconnectable that refers to it.
+    explicit FastSignalBase(std::pmr::memory_resource *mr) : callbacks(mr), live(mr) {
+        FASTSIGNAL_STATS_ADD(signals, 1);
+    }
+
+    FastSignalBase(const FastSignalBase&) {
+        FASTSIGNAL_STATS_ADD(signals, 1);
+    }
+    FastSignalBase& operator=(const FastSignalBase&) { return *this; }
+
+    // O(1), the connections point to the anchor and the anchor moves with the signal.
+    // noexcept so that containers of signals move them on reallocation instead of copying them
+    FastSignalBase(FastSignalBase &&other) noexcept :
+        is_dirty(other.is_dirty), blocked(other.blocked), lists_dirty(other.lists_dirty), once_list(other.once_list),
+            extension(other.extension), callbacks(std::move(other.callbacks)), live(std::move(other.live)),
+            callback_count(other.callback_count), anchor(other.anchor) {
+        // The moved-from signal is left empty and can be emitted or connected to again
+        other.is_dirty = false;
+        other.blocked = false;
+        other.lists_dirty = false;
+        other.callback_count = 0;
+        other.once_list = 0;
+        other.extension = nullptr;
+        other.anchor = nullptr;
+        FASTSIGNAL_STATS_ADD(signals, 1);
+
+        if (anchor)
+            anchor->sig = this;
+    }
+
+    // O(1) when this signal has no slots, otherwise its own slots are disconnected first
+    FastSignalBase& operator=(FastSignalBase &&other) {
+        if (this == &other)
+            return *this;
+
+        detach_all();
+        release_extension();
+
+        callbacks = std::move(other.callbacks);
+        live = std::move(other.live);
+        callback_count = other.callback_count;
+        is_dirty = other.is_dirty;
+        blocked = other.blocked;
+        extension = other.extension;
+        lists_dirty = other.lists_dirty;
+        once_list = other.once_list;
+        anchor = other.anchor;
+        // Moved element by element when the resources differ, the moved-from slots would look like permanent ones
+        other.callbacks.clear();
+        other.is_dirty = false;
+        other.blocked = false;
+        other.lists_dirty = false;
+        other.callback_count = 0;
+        other.once_list = 0;
+        other.extension = nullptr;
+        other.anchor = nullptr;
+
+        if (anchor)
+            anchor->sig = this;
+
+        return *this;
+    }
+
+    virtual ~FastSignalBase() {
+        if (current_teardown())
+            release_all();
+        else
+            detach_all();
+        release_extension();
+        FASTSIGNAL_STATS_ADD(signals, -1);
+    }
+
+    std::pmr::memory_resource *resource() const {
+        return callbacks.get_allocator().resource();
+    }
+
+    void update_sig_obj(uint32_t list, int index, Disconnectable *obj) {
+        slots(list)[index].obj = obj;
+    }
+
+    void dirty(uint32_t list, int index) {
+        if (list == 0) {
+            is_dirty = true;
+        } else {
+            slot_list(list).is_dirty = true;
+            lists_dirty = true;
+        }
+        --callback_count;
+        FASTSIGNAL_STATS_ADD(slots, -1);
+        FASTSIGNAL_STATS_ADD(tombstones, 1);
+
+        Callback &cb = slots(list)[index];
+        FASTSIGNAL_RECORD_DISCONNECT(anchor, cb.conn.get());
+        cb.fun = nullptr;
+        cb.obj = nullptr;
+        live_slots(list).kill(index);
+    }
+
+    // A blocked slot keeps its place in the array, only its function is parked in the connection.
+    // The slot is marked dead in the liveness bitmap, the emission skips it without reading it
+    // and the signal isn't dirtied.
+    void *block_slot(uint32_t list, int index) {
+        Callback &cb = slots(list)[index];
+        void *fun = cb.fun;
+        cb.fun = nullptr;
+        live_slots(list).kill(index);
+        return fun;
+    }
+
+    void unblock_slot(uint32_t list, int index, void *fun) {
+        slots(list)[index].fun = fun;
+        live_slots(list).revive(index);
+    }
+
+    void block() {
+        blocked = true;
+    }
+
+    void unblock() {
+        blocked = false;
+    }
+
+    bool is_blocked() const {
+        return blocked;
+    }
+
+    size_t count() const {
+        return callback_count;
+    }
+
+    // Room for slot_count slots in total, connecting up to it doesn't grow the slot arrays
+    void reserve(size_t slot_count) {
+        callbacks.reserve(slot_count);
+        live.words.reserve((slot_count + LiveSlots::WORD_BITS - 1) / LiveSlots::WORD_BITS);
+    }
+
+    // O(slots), walks the slots to count the connection records
+    MemoryUsage memory_usage() const {
+        return base_memory_usage();
+    }
+
+    // Removes the tombstones and releases the unused capacity. Not from a slot of this signal.
+    void shrink_to_fit() {
+        compact();
+        for_each_list([](std::pmr::vector<Callback> &list, LiveSlots &list_live) {
+            list.shrink_to_fit();
+            list_live.words.shrink_to_fit();
+        });
+    }
+};
+
+inline void Connection::disconnect()
+{
+    for (Connection *conn = this; conn != this + record_count; ++conn)
+        conn->disconnect_slot();
+}
+
+inline void Connection::block()
+{
+    for (Connection *conn = this; conn != this + record_count; ++conn)
+        conn->block_slot();
+}
+
+inline void Connection::unblock()
+{
+    for (Connection *conn = this; conn != this + record_count; ++conn)
+        conn->unblock_slot();
+}
+
+inline void Connection::update_sig_obj(Disconnectable *obj) {
+    for (Connection *conn = this; conn != this + record_count; ++conn) {
+        if (FastSignalBase *sig = conn->signal())
+            sig->update_sig_obj(conn->list, conn->index, obj);
+    }
+}
+
+inline void Connection::disconnect_slot()
+{
+    if (!anchor)
+        return;
+
+    blocked_fun = nullptr;
+    if (FastSignalBase *sig = anchor->sig)
+        sig->dirty(list, index);
+    detach();
+}
+
+inline void Connection::block_slot()
+{
+    FastSignalBase *sig = signal();
+    if (!sig || blocked_fun)
+        return;
+
+    blocked_fun = sig->block_slot(list, index);
+}
+
+inline void Connection::unblock_slot()
+{
+    FastSignalBase *sig = signal();
+    if (!sig || !blocked_fun)
+        return;
+
+    sig->unblock_slot(list, index, blocked_fun);
+    blocked_fun = nullptr;
+}
+
+} // namespace internal
+
+class Disconnectable
+{
+    std::pmr::vector<std::weak_ptr<internal::Connection>> connections;
+
+    template<typename Signature>
+    friend class FastSignal;
+    template<typename... Signatures>
+    friend class SignalGroup;
+    friend class internal::FastSignalBase;
+
+    void add_connection(std::shared_ptr<internal::Connection> conn) {
+        connections.emplace_back(conn);
+    }
+
+public:
+
+    Disconnectable() = default;
+
+    explicit Disconnectable(std::pmr::memory_resource *mr) : connections(mr) {}
+
+    Disconnectable(const Disconnectable&) {};
+    Disconnectable& operator=(const Disconnectable&) { return *this; };
+
+    Disconnectable(Disconnectable &&other) noexcept : connections(std::move(other.connections)) {
+        for (auto &conn : connections) {
+            std::shared_ptr<internal::Connection> sp = conn.lock();
+            if (!sp)
+                continue;
+            sp->update_sig_obj(this);
+        }
+    };
+    Disconnectable& operator=(Disconnectable &&other) {
+        connections = std::move(other.connections);
+        for (auto &conn : connections) {
+            std::shared_ptr<internal::Connection> sp = conn.lock();
+            if (!sp)
+                continue;
+            sp->update_sig_obj(this);
+        }
+        return *this;
+    };
+
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        size_t expired = 0;
+        for (const auto &conn : connections) {
+            std::shared_ptr<internal::Connection> sp = conn.lock();
+            if (sp && sp->is_attached()) {
+                ++usage.slots;
+            } else {
+                ++usage.tombstones;
+                // The records of add_range() are freed with their block, which the signal still holds
+                expired += !sp;
+            }
+        }
+        usage.capacity = connections.capacity();
+        usage.heap_bytes = connections.capacity() * sizeof(std::weak_ptr<internal::Connection>) +
+            expired * internal::connection_record_bytes();
+        return usage;
+    }
+
+    // Drops the disconnected connections, which frees their connection records, and releases the unused capacity
+    void shrink_to_fit() {
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+            [](const std::weak_ptr<internal::Connection> &conn) {
+                std::shared_ptr<internal::Connection> sp = conn.lock();
+                return !sp || !sp->is_attached();
+            }), connections.end());
+        connections.shrink_to_fit();
+    }
+
+    virtual ~Disconnectable() {
+        // The signals are destroyed in the same scope, nothing to disconnect from
+        if (internal::current_teardown())
+            return;
+
+        for (auto &conn : connections) {
+            std::shared_ptr<internal::Connection> sp = conn.lock();
+            if (!sp)
+                continue;
+            sp->disconnect();
+            conn.reset();
+        }
+    }
+};
+
+class ConnectionView
+{
+    std::weak_ptr<internal::Connection> connection;
+
+public:
+    ConnectionView(std::shared_ptr<internal::Connection> connection = nullptr) : connection(connection) {}
+
+    ~ConnectionView() {
+        connection.reset();
+    }
+
+    ConnectionView(const ConnectionView &other) {
+        connection = other.connection;
+    }
+
+    ConnectionView& operator=(const ConnectionView &other) {
+        connection = other.connection;
+        return *this;
+    }
+
+    ConnectionView(ConnectionView &&other) : connection(other.connection) {
+        other.connection.reset();
+    }
+
+    ConnectionView& operator=(ConnectionView &&other) {
+        connection = other.connection;
+        other.connection.reset();
+        return *this;
+    }
+
+    void disconnect() {
+        std::shared_ptr<internal::Connection> conn = connection.lock();
+        if (!conn)
+            return;
+
+        conn->disconnect();
+        connection.reset();
+    }
+
+    // Blocking a connection doesn't disconnect it, the slot is skipped until unblock() is called
+    void block() {
+        std::shared_ptr<internal::Connection> conn = connection.lock();
+        if (!conn)
+            return;
+
+        conn->block();
+    }
+
+    void unblock() {
+        std::shared_ptr<internal::Connection> conn = connection.lock();
+        if (!conn)
+            return;
+
+        conn->unblock();
+    }
+};
+
+// Owns a group of signals and Disconnectable objects, created with make() or handed over with adopt(),
+// and destroys them together in reverse order when it is destroyed. They don't disconnect from each other:
+// the signals release their slots and the objects their connections, without per-connection work
+// and without dirtying the signals. The objects they own (members, elements of an adopted container) do the same.
+// Other objects, destroyed before, during or after it on any thread, disconnect as usual.
+// Everything connected to the scope's objects must be owned by the scope too: no emission of another signal,
+// no use of a ConnectionView and no event loop delivery for their slots after the scope is destroyed.
+class TeardownScope
+{
+    struct Object
+    {
+        void *ptr;
+        void (*destroy)(void*);
+    };
+
+    std::vector<Object> objects;
+
+public:
+    TeardownScope() = default;
+
+    ~TeardownScope() {
+        internal::Teardown teardown;
+        internal::Teardown *outer = std::exchange(internal::current_teardown(), &teardown);
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+            it->destroy(it->ptr);
+        internal::current_teardown() = outer;
+
+        while (internal::SignalAnchor *anchor = teardown.released) {
+            teardown.released = anchor->next;
+            internal::free_anchor(anchor);
+        }
+    }
+
+    TeardownScope(const TeardownScope&) = delete;
+    TeardownScope& operator=(const TeardownScope&) = delete;
+
+    template<class T, typename... Args>
+    T& make(Args&&... args) {
+        return adopt(std::make_unique<T>(std::forward<Args>(args)...));
+    }
+
+    template<class T>
+    T& adopt(std::unique_ptr<T> object) {
+        objects.reserve(objects.size() + 1);
+        T *ptr = object.release();
+        objects.push_back({ptr, [](void *p) { delete static_cast<T*>(p); }});
+        return *ptr;
+    }
+};
+
+// Blocks a group of signals for the lifetime of the blocker.
+// On destruction every signal is restored to the state it had before, so blockers can be nested.
+template<size_t N>
+class SignalBlocker
+{
+    std::array<std::pair<internal::FastSignalBase*, bool>, N> signals;
+
+public:
+    template<typename... Signals>
+    explicit SignalBlocker(Signals&... sigs) : signals{{{&sigs, sigs.is_blocked()}...}} {
+        for (auto &[sig, was_blocked] : signals)
+            sig->block();
+    }
+
+    ~SignalBlocker() {
+        for (auto &[sig, was_blocked] : signals) {
+            if (!was_blocked)
+                sig->unblock();
+        }
+    }
+
+    SignalBlocker(const SignalBlocker&) = delete;
+    SignalBlocker& operator=(const SignalBlocker&) = delete;
+};
+
+template<typename... Signals>
+SignalBlocker(Signals&...) -> SignalBlocker<sizeof...(Signals)>;
+
+#ifdef FASTSIGNAL_TRACE
+// Timeline of the emissions, compiled in with FASTSIGNAL_TRACE only.
+// Every emission is recorded as a span, slots too once enabled with set_slot_spans(true).
+// A thread records into its own fixed buffer without locks, the spans past its capacity are dropped.
+// write_chrome_trace() writes the spans of all the threads as Chrome trace JSON, for chrome://tracing or Perfetto.
+namespace trace {
+
+#ifndef FASTSIGNAL_TRACE_CAPACITY
+#define FASTSIGNAL_TRACE_CAPACITY (1 << 16)
+#endif
+
+struct Event
+{
+    // The signal for an emission, the slot's object (or function) for a slot
+    const void *target;
+    // ns since the first traced span
+    int64_t start;
+    int64_t duration;
+    bool is_slot;
+};
+
+struct ThreadBuffer
+{
+    Event events[FASTSIGNAL_TRACE_CAPACITY];
+    // Published with release, the events before size can be read from any thread
+    std::atomic<size_t> size{0};
+    std::atomic<size_t> dropped{0};
+    uint32_t thread_id = 0;
+    ThreadBuffer *next = nullptr;
+};
+
+inline std::atomic<ThreadBuffer*>& buffers() {
+    static std::atomic<ThreadBuffer*> head{nullptr};
+    return head;
+}
+
+inline std::atomic<bool>& slot_spans() {
+    static std::atomic<bool> enabled{false};
+    return enabled;
+}
+
+inline int64_t now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+// Registered on the first span of the thread and never freed, the spans outlive the thread until written
+inline ThreadBuffer& thread_buffer() {
+    thread_local ThreadBuffer *buffer = []() {
+        static std::atomic<uint32_t> next_thread_id{1};
+
+        ThreadBuffer *new_buffer = new ThreadBuffer();
+        new_buffer->thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+
+        ThreadBuffer *head = buffers().load(std::memory_order_relaxed);
+        do {
+            new_buffer->next = head;
+        } while (!buffers().compare_exchange_weak(head, new_buffer, std::memory_order_release, std::memory_order_relaxed));
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+inline void record(const void *target, int64_t start, int64_t duration, bool is_slot) {
+    ThreadBuffer &buffer = thread_buffer();
+    size_t size = buffer.size.load(std::memory_order_relaxed);
+    if (size == FASTSIGNAL_TRACE_CAPACITY) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[size] = {target, start, duration, is_slot};
+    buffer.size.store(size + 1, std::memory_order_release);
+}
+
+// Recorded when it ends, spans are complete events and nest without begin/end pairs
+class Span
+{
+    const void *target;
+    int64_t start;
+
+public:
+    explicit Span(const void *target) : target(target), start(now()) {}
+
+    ~Span() {
+        record(target, start, now() - start, false);
+    }
+};
+
+class SlotSpan
+{
+    const void *target;
+    int64_t start = -1;
+
+public:
+    explicit SlotSpan(const void *target) : target(target) {
+        if (slot_spans().load(std::memory_order_relaxed))
+            start = now();
+    }
+
+    ~SlotSpan() {
+        if (start >= 0)
+            record(target, start, now() - start, true);
+    }
+};
+
+inline void set_slot_spans(bool enabled) {
+    slot_spans().store(enabled, std::memory_order_relaxed);
+}
+
+// Spans that didn't fit in their thread's buffer
+inline size_t dropped() {
+    size_t count = 0;
+    for (ThreadBuffer *buffer = buffers().load(std::memory_order_acquire); buffer; buffer = buffer->next)
+        count += buffer->dropped.load(std::memory_order_relaxed);
+    return count;
+}
+
+// Not synchronized with the threads recording spans, call it when nothing is emitted
+inline void clear() {
+    for (ThreadBuffer *buffer = buffers().load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        buffer->size.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+// One event per line, timestamps in microseconds
+inline void write_chrome_trace(std::ostream &out) {
+    out << "{\"traceEvents\":[";
+
+    const char *separator = "\n";
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    for (ThreadBuffer *buffer = buffers().load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        size_t size = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; i++) {
+            const Event &event = buffer->events[i];
+            out << separator
+                << "{\"name\":\"" << (event.is_slot ? "slot" : "emit") << "\","
+                << "\"cat\":\"fastsignal\",\"ph\":\"X\","
+                << "\"ts\":" << event.start / 1000.0 << ","
+                << "\"dur\":" << event.duration / 1000.0 << ","
+                << "\"pid\":1,\"tid\":" << buffer->thread_id << ","
+                << "\"args\":{\"" << (event.is_slot ? "slot" : "signal") << "\":\"" << event.target << "\"}}";
+            separator = ",\n";
+        }
+    }
+    out.flags(flags);
+    out.precision(precision);
+
+    out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":" << dropped() << "}}\n";
+}
+
+inline bool write_chrome_trace(const char *path) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    write_chrome_trace(out);
+    return static_cast<bool>(out);
+}
+
+} // namespace trace
+#endif
+
+// A queue of tasks run on the thread that owns the loop, the thread that created it or called attach() or run().
+// Slots connected with add_on() run on the loop's thread: an emission from another thread posts one task
+// per loop with a copy of the arguments and all the loop's slots, and wakes the loop once for it.
+// Posting is lock-free, the mutex is only taken to wake up a loop sleeping in run().
+class EventLoop
+{
+public:
+    struct Task
+    {
+        Task *next = nullptr;
+        void (*run)(Task *task, bool cancelled) = nullptr;
+    };
+
+private:
+    // Lock-free stack of pending tasks, the consumer takes the whole stack at once
+    std::atomic<Task*> head{nullptr};
+    std::atomic<std::thread::id> owner{std::this_thread::get_id()};
+    std::atomic<bool> stopped{false};
+    std::atomic<size_t> wakeup_count{0};
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+
+    void notify() {
+        wakeup_count.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_one();
+    }
+
+public:
+    EventLoop() = default;
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Pending tasks are dropped without running
+    ~EventLoop() {
+        Task *task = head.exchange(nullptr, std::memory_order_acquire);
+        while (task) {
+            Task *next = task->next;
+            task->run(task, true);
+            task = next;
+        }
+    }
+
+    // Makes the calling thread the loop's thread
+    void attach() {
+        owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    bool is_current() const {
+        return owner.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    // Takes ownership of task, it's run and destroyed by task->run on the loop's thread.
+    // The loop is woken up only when the queue was empty, a loop that is already awake takes the new tasks too.
+    void post(Task *task) {
+        Task *old_head = head.load(std::memory_order_relaxed);
+        do {
+            task->next = old_head;
+        } while (!head.compare_exchange_weak(old_head, task, std::memory_order_release, std::memory_order_relaxed));
+
+        if (!old_head)
+            notify();
+    }
+
+    // Runs the pending tasks in the order they were posted, returns how many ran
+    size_t process_events() {
+        Task *task = head.exchange(nullptr, std::memory_order_acquire);
+
+        Task *ordered = nullptr;
+        while (task) {
+            Task *next = task->next;
+            task->next = ordered;
+            ordered = task;
+            task = next;
+        }
+
+        size_t count = 0;
+        while (ordered) {
+            Task *next = ordered->next;
+            ordered->run(ordered, false);
+            ordered = next;
+            ++count;
+        }
+        return count;
+    }
+
+    // Runs the tasks as they are posted until stop() is called, on the calling thread
+    void run() {
+        attach();
+        while (!stopped.load(std::memory_order_acquire)) {
+            process_events();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this]() {
+                return head.load(std::memory_order_acquire) || stopped.load(std::memory_order_acquire);
+            });
+        }
+        process_events();
+    }
+
+    // Can be called from any thread, run() returns after the pending tasks
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped.store(true, std::memory_order_release);
+        }
+        wakeup.notify_one();
+    }
+
+    size_t wakeups() const {
+        return wakeup_count.load(std::memory_order_relaxed);
+    }
+};
+
+namespace internal {
+
+template<typename... Types>
+struct FirstType
+{
+    using type = void;
+};
+
+template<typename First, typename... Rest>
+struct FirstType<First, Rest...>
+{
+    using type = std::decay_t<First>;
+};
+
+template<typename Key, typename = void>
+struct is_filter_key : std::false_type {};
+
+template<typename Key>
+struct is_filter_key<Key, std::void_t<
+    decltype(std::declval<const Key&>() < std::declval<const Key&>()),
+    decltype(std::declval<const Key&>() == std::declval<const Key&>())>> : std::true_type {};
+
+template<typename Fun>
+struct MemberFunTraits
+{
+    static constexpr bool is_member = false;
+};
+
+template<typename Class, typename Ret, typename... Params>
+struct MemberFunTraits<Ret (Class::*)(Params...)>
+{
+    static constexpr bool is_member = true;
+    using ClassType = Class;
+    using ParamTypes = std::tuple<Params...>;
+};
+
+template<typename Class, typename Ret, typename... Params>
+struct MemberFunTraits<Ret (Class::*)(Params...) const> : MemberFunTraits<Ret (Class::*)(Params...)> {};
+
+template<typename Class, typename Ret, typename... Params>
+struct MemberFunTraits<Ret (Class::*)(Params...) noexcept> : MemberFunTraits<Ret (Class::*)(Params...)> {};
+
+template<typename Class, typename Ret, typename... Params>
+struct MemberFunTraits<Ret (Class::*)(Params...) const noexcept> : MemberFunTraits<Ret (Class::*)(Params...)> {};
+
+// Finds the function a call of fun on obj reaches, looking up the vtable once.
+// On success obj is adjusted to the this pointer the function expects.
+// Relies on the Itanium C++ ABI layout of member function pointers and vtables,
+// returns false on the targets where that layout isn't known to hold.
+template<typename Fun>
+bool resolve_member(Fun fun, void *&obj, void *&resolved)
+{
+#if (defined(__x86_64__) || defined(__aarch64__)) && !defined(_WIN32)
+    struct ItaniumMemberPointer
+    {
+        uintptr_t ptr;
+        ptrdiff_t adj;
+    };
+
+    if constexpr (sizeof(Fun) != sizeof(ItaniumMemberPointer)) {
+        return false;
+    } else {
+        ItaniumMemberPointer mp;
+        std::memcpy(&mp, &fun, sizeof(mp));
+
+#if defined(__aarch64__)
+        // ARM keeps the virtual flag in the adjustment, the pointer is the vtable offset
+        bool is_virtual = mp.adj & 1;
+        ptrdiff_t adj = mp.adj >> 1;
+        uintptr_t offset = mp.ptr;
+#else
+        bool is_virtual = mp.ptr & 1;
+        ptrdiff_t adj = mp.adj;
+        uintptr_t offset = mp.ptr - 1;
+#endif
+
+        char *self = static_cast<char*>(obj) + adj;
+        if (is_virtual) {
+            char *vtable = *reinterpret_cast<char**>(self);
+            std::memcpy(&resolved, vtable + offset, sizeof(resolved));
+        } else {
+            resolved = reinterpret_cast<void*>(mp.ptr);
+        }
+
+        obj = self;
+        return resolved != nullptr;
+    }
+#else
+    (void)fun;
+    (void)obj;
+    (void)resolved;
+    return false;
+#endif
+}
+
+// Maps every filter key to the slot list holding the slots filtered on it
+template<typename Key>
+struct FilterIndex
+{
+    // Sorted by key
+    std::pmr::vector<std::pair<Key, uint32_t>> entries;
+
+    explicit FilterIndex(std::pmr::memory_resource *mr) : entries(mr) {}
+
+    auto lower_bound(const Key &key) const {
+        return std::lower_bound(entries.begin(), entries.end(), key,
+            [](const std::pair<Key, uint32_t> &entry, const Key &key) { return entry.first < key; });
+    }
+
+    // Returns 0 if there are no slots filtered on key
+    uint32_t find(const Key &key) const {
+        auto it = lower_bound(key);
+        if (it == entries.end() || !(it->first == key))
+            return 0;
+        return it->second;
+    }
+
+    void insert(const Key &key, uint32_t list) {
+        entries.emplace(lower_bound(key), key, list);
+    }
+};
+
+// Maps every event loop to the slot list holding the slots delivered on it.
+// In the order the loops were added, not sorted: the emission walks the entries by index
+// and a slot may add a loop meanwhile. Signals are connected to a few loops, the search is linear.
+struct LoopIndex
+{
+    std::pmr::vector<std::pair<EventLoop*, uint32_t>> entries;
+
+    explicit LoopIndex(std::pmr::memory_resource *mr) : entries(mr) {}
+
+    // Returns 0 if there are no slots delivered on loop
+    uint32_t find(const EventLoop *loop) const {
+        for (auto &[entry_loop, list] : entries) {
+            if (entry_loop == loop)
+                return list;
+        }
+        return 0;
+    }
+
+    void insert(EventLoop *loop, uint32_t list) {
+        entries.emplace_back(loop, list);
+    }
+};
+
+// Both ends of the forwarding links of a signal, part of its extension
+template<typename Signal>
+struct ForwardLinks
+{
+    // Signals emitted after this one's slots
+    std::pmr::vector<Signal*> targets;
+    // Signals forwarding to this one
+    std::pmr::vector<Signal*> sources;
+
+    explicit ForwardLinks(std::pmr::memory_resource *mr) : targets(mr), sources(mr) {}
+
+    static void replace(std::pmr::vector<Signal*> &list, Signal *from, Signal *to) {
+        std::replace(list.begin(), list.end(), from, to);
+    }
+
+    static void remove(std::pmr::vector<Signal*> &list, Signal *sig) {
+        list.erase(std::remove(list.begin(), list.end(), sig), list.end());
+    }
+};
+
+} // namespace internal
+
+template<typename RetType, typename... ArgTypes>
+class FastSignal<RetType(ArgTypes...)> final : public internal::FastSignalBase
+{
+    using CallbackType = std::function<RetType(ArgTypes...)>;
+
+    using FirstArg = typename internal::FirstType<ArgTypes...>::type;
+    static constexpr bool is_filterable = internal::is_filter_key<FirstArg>::value;
+    using FilterKey = std::conditional_t<is_filterable, FirstArg, std::nullptr_t>;
+
+    using ForwardLinks = internal::ForwardLinks<FastSignal>;
+
+    // The indexes of the filtered slots and of the add_on() slots, next to the slot lists, and the forwarding links
+    struct Extension final : internal::SignalExtension
+    {
+        internal::FilterIndex<FilterKey> filter_index;
+        // The slot list of every event loop with slots connected through add_on()
+        internal::LoopIndex loop_index;
+        ForwardLinks forwarding;
+
+        explicit Extension(std::pmr::memory_resource *mr) :
+            internal::SignalExtension(mr), filter_index(mr), loop_index(mr), forwarding(mr) {}
+
+        static Extension* make(std::pmr::memory_resource *mr) {
+            std::pmr::polymorphic_allocator<Extension> alloc(mr);
+            return new (alloc.allocate(1)) Extension(mr);
+        }
+
+        void destroy() override {
+            std::pmr::polymorphic_allocator<Extension> alloc(slot_lists.get_allocator().resource());
+            this->~Extension();
+            alloc.deallocate(this, 1);
+        }
+    };
+
+    // nullptr for the signals that use none of the features of the extension
+    Extension* ext() const {
+        return static_cast<Extension*>(extension);
+    }
+
+    Extension& get_extension() {
+        if (!extension)
+            extension = Extension::make(resource());
+        return *ext();
+    }
+
+    // The peers of a moved signal point to its old address
+    void relink(FastSignal *old) {
+        if (!extension)
+            return;
+        for (auto *target : ext()->forwarding.targets)
+            ForwardLinks::replace(target->ext()->forwarding.sources, old, this);
+        for (auto *source : ext()->forwarding.sources)
+            ForwardLinks::replace(source->ext()->forwarding.targets, old, this);
+    }
+
+    void unlink() {
+        if (!extension)
+            return;
+        ForwardLinks &forwarding = ext()->forwarding;
+        for (auto *target : forwarding.targets)
+            ForwardLinks::remove(target->ext()->forwarding.sources, this);
+        for (auto *source : forwarding.sources)
+            ForwardLinks::remove(source->ext()->forwarding.targets, this);
+        forwarding.targets.clear();
+        forwarding.sources.clear();
+    }
+
+    bool forwards_to(const FastSignal *target) const {
+        if (target == this)
+            return true;
+        if (!extension)
+            return false;
+        for (auto *next : ext()->forwarding.targets) {
+            if (next->forwards_to(target))
+                return true;
+        }
+        return false;
+    }
+
+    template<auto fun, class ObjType>
+    static void *member_thunk() {
+        return reinterpret_cast<void*>(+[](void *obj, const ArgTypes&... args) -> RetType {
+            (reinterpret_cast<ObjType*>(obj)->*fun)(args...);
+        });
+    }
+
+    template<auto fun, class ObjType>
+    ConnectionView connect(ObjType *obj, uint32_t list) {
+        using FunType = decltype(fun);
+        static_assert(std::is_invocable_v<FunType, ObjType*, ArgTypes...>,
+            "Callback must be invocable with the signal's declared parameters");
+        static_assert(std::is_same_v<std::invoke_result_t<FunType, ObjType*, ArgTypes...>, RetType>,
+            "Callback must return the signal's declared return type");
+
+        constexpr bool is_disconnectable = std::is_base_of_v<Disconnectable, ObjType>;
+
+        std::shared_ptr<internal::Connection> conn = make_connection(is_disconnectable, list);
+        push_slot(list, {reinterpret_cast<void*>(obj), member_thunk<fun, ObjType>(), conn});
+
+        if constexpr (is_disconnectable)
+            obj->add_connection(conn);
+
+        return ConnectionView(conn);
+    }
+
+    // A slot of connect_all(), conn is part of the record shared with the slots of the other signals
+    template<auto fun, class ObjType>
+    void connect_shared(ObjType *obj, std::shared_ptr<internal::Connection> conn, bool is_first) {
+        static_assert(std::is_invocable_v<decltype(fun), ObjType*, ArgTypes...>,
+            "Callback must be invocable with the signal's declared parameters");
+        static_assert(std::is_same_v<std::invoke_result_t<decltype(fun), ObjType*, ArgTypes...>, RetType>,
+            "Callback must return the signal's declared return type");
+
+        constexpr bool is_disconnectable = std::is_base_of_v<Disconnectable, ObjType>;
+
+        conn->anchor = get_anchor();
+        conn->index = callbacks.size();
+        conn->is_disconnectable = is_disconnectable;
+        conn->in_block = true;
+        push_slot(0, {reinterpret_cast<void*>(obj), member_thunk<fun, ObjType>(), conn});
+
+        // The object only knows the first connection, which stands for the whole record
+        if constexpr (is_disconnectable) {
+            if (is_first)
+                obj->add_connection(std::move(conn));
+        }
+    }
+
+    template<auto... funs, class OtherObjType, typename... Signals>
+    friend ConnectionView connect_all(OtherObjType *obj, Signals&... signals);
+
+    // The resolved function is stored in place of the thunk, it's called like one:
+    // with the object first and the arguments by const reference.
+    template<auto fun, class ObjType>
+    ConnectionView connect_devirtualized(ObjType *obj, uint32_t list) {
+        using FunType = decltype(fun);
+        static_assert(std::is_invocable_v<FunType, ObjType*, ArgTypes...>,
+            "Callback must be invocable with the signal's declared parameters");
+        static_assert(std::is_same_v<std::invoke_result_t<FunType, ObjType*, ArgTypes...>, RetType>,
+            "Callback must return the signal's declared return type");
+
+        using Traits = internal::MemberFunTraits<FunType>;
+
+        if constexpr (!Traits::is_member || std::is_base_of_v<Disconnectable, ObjType>) {
+            // Disconnectable objects are rebound on move, the resolved function may not fit the new object
+            return connect<fun>(obj, list);
+        } else if constexpr (!std::is_same_v<typename Traits::ParamTypes, std::tuple<const ArgTypes&...>>) {
+            return connect<fun>(obj, list);
+        } else {
+            void *self = static_cast<typename Traits::ClassType*>(obj);
+            void *resolved = nullptr;
+            if (!internal::resolve_member(fun, self, resolved))
+                return connect<fun>(obj, list);
+
+            std::shared_ptr<internal::Connection> conn = make_connection(false, list);
+            push_slot(list, {self, resolved, conn});
+            return ConnectionView(conn);
+        }
+    }
+
+    ConnectionView connect(RetType(fun)(ArgTypes...), uint32_t list) {
+        std::shared_ptr<internal::Connection> conn = make_connection(false, list);
+        push_slot(list, {nullptr, reinterpret_cast<void*>(fun), conn});
+        return ConnectionView(conn);
+    }
+
+    uint32_t filter_list(const FilterKey &key) {
+        static_assert(is_filterable,
+            "Filtered slots require the signal's first parameter to be comparable with < and ==");
+
+        Extension &extended = get_extension();
+        uint32_t list = extended.filter_index.find(key);
+        if (list)
+            return list;
+
+        list = new_slot_list(extended);
+        extended.filter_index.insert(key, list);
+        return list;
+    }
+
+    uint32_t loop_list(EventLoop &loop) {
+        Extension &extended = get_extension();
+        uint32_t list = extended.loop_index.find(&loop);
+        if (list)
+            return list;
+
+        list = new_slot_list(extended);
+        extended.loop_index.insert(&loop, list);
+        return list;
+    }
+
+    // The slots of a loop for one emission, with a copy of the arguments
+    struct Delivery : EventLoop::Task
+    {
+        std::tuple<std::decay_t<ArgTypes>...> args;
+        std::vector<internal::Callback> slots;
+
+        template<typename... ActualArgs>
+        explicit Delivery(const ActualArgs&... args) : args(args...) {
+            run = &Delivery::deliver;
+        }
+
+        static void deliver(EventLoop::Task *task, bool cancelled) {
+            std::unique_ptr<Delivery> delivery(static_cast<Delivery*>(task));
+            if (cancelled)
+                return;
+
+            for (auto &cb : delivery->slots) {
+                // Disconnected after the emission
+                if (!cb.conn->is_connected.load(std::memory_order_acquire))
+                    continue;
+                std::apply([&cb](auto&... args) { call(cb.obj, cb.fun, args...); }, delivery->args);
+            }
+        }
+    };
+
+    template<typename... ActualArgs>
+    void emit_on_loops(ActualArgs&&... args) const {
+        // Loops added by the slots are for the next emission
+        const internal::LoopIndex &loop_index = ext()->loop_index;
+        size_t count = loop_index.entries.size();
+        for (size_t i = 0; i < count; ++i) {
+            auto [loop, list] = loop_index.entries[i];
+            const internal::SlotList &loop_slots = slot_list(list);
+            if (loop->is_current()) {
+                emit<0>(loop_slots.callbacks, loop_slots.live, args...);
+                continue;
+            }
+
+            std::unique_ptr<Delivery> delivery;
+            for (auto &cb : loop_slots.callbacks) {
+                if (cb.fun == nullptr)
+                    continue;
+                if (!delivery)
+                    delivery = std::make_unique<Delivery>(args...);
+                delivery->slots.push_back(cb);
+            }
+
+            if (delivery)
+                loop->post(delivery.release());
+        }
+    }
+
+    template<typename... ActualArgs>
+    static void call(void *obj, void *fun, ActualArgs&&... args) {
+        FASTSIGNAL_TRACE_SLOT(obj ? obj : fun);
+
+        if (obj)
+            reinterpret_cast<RetType(*)(void*, const ArgTypes&...)>(fun)(obj, std::forward<ActualArgs>(args)...);
+        else
+            reinterpret_cast<RetType(*)(ArgTypes...)>(fun)(std::forward<ActualArgs>(args)...);
+    }
+
+    template<size_t PrefetchDistance, typename... ActualArgs>
+    static void emit(const std::pmr::vector<internal::Callback> &list, const internal::LiveSlots &live,
+            ActualArgs&&... args) {
+        // Indexed, a slot may connect to the list and reallocate it. Slots added by the slots are for the next emission.
+        size_t size = list.size();
+
+        if (!live.dead) {
+            if constexpr (PrefetchDistance > 0) {
+                // The objects of the next slots are fetched while the current one runs
+                size_t ahead = std::min(PrefetchDistance, size);
+                for (size_t i = 0; i < size; ++i) {
+                    if (ahead != size)
+                        internal::prefetch(list[ahead++].obj);
+
+                    const internal::Callback &cb = list[i];
+                    if (cb.fun == nullptr)
+                        continue;
+                    call(cb.obj, cb.fun, std::forward<ActualArgs>(args)...);
+                }
+                return;
+            }
+
+            for (size_t i = 0; i < size; ++i) {
+                const internal::Callback &cb = list[i];
+                // Disconnected by an earlier slot of this emission
+                if (cb.fun == nullptr)
+                    continue;
+                call(cb.obj, cb.fun, std::forward<ActualArgs>(args)...);
+            }
+            return;
+        }
+
+        // Only the live slots are read, a word of dead slots is skipped with a single test
+        for (size_t w = 0; w * internal::LiveSlots::WORD_BITS < size; ++w) {
+            for (uint64_t bits = live.words[w]; bits; bits &= bits - 1) {
+                size_t i = w * internal::LiveSlots::WORD_BITS + internal::count_trailing_zeros(bits);
+                if (i >= size)
+                    break;
+
+                const internal::Callback &cb = list[i];
+                if (cb.fun == nullptr)
+                    continue;
+                call(cb.obj, cb.fun, std::forward<ActualArgs>(args)...);
+            }
+        }
+    }
+
+    template<typename... ActualArgs>
+    void emit_once(ActualArgs&&... args) const {
+        is_emitting_once = true;
+
+        // Stays in place when a slot adds a slot list, and is indexed since a slot may add one-shot slots
+        auto &list = slot_list(once_list).callbacks;
+        // Slots added by the slots are for the next emission
+        size_t size = list.size();
+        for (size_t i = 0; i < size; i++) {
+            internal::Callback &cb = list[i];
+            if (cb.fun == nullptr)
+                continue;
+
+            // Disconnected before the call, disconnecting from inside the slot is a no-op
+            void *obj = cb.obj;
+            void *fun = cb.fun;
+            cb.fun = nullptr;
+            FASTSIGNAL_RECORD_DISCONNECT(anchor, cb.conn.get());
+            cb.conn->detach();
+            --callback_count;
+            FASTSIGNAL_STATS_ADD(slots, -1);
+            FASTSIGNAL_STATS_ADD(tombstones, 1);
+
+            call(obj, fun, args...);
+        }
+
+        consume_once();
+        is_emitting_once = false;
+    }
+
+    template<size_t PrefetchDistance, typename... ActualArgs>
+    void emit_all(ActualArgs&&... args) const {
+        if (blocked)
+            return;
+
+        FASTSIGNAL_TRACE_EMISSION(this);
+        FASTSIGNAL_RECORD_EMISSION(anchor, args);
+
+        // Looked up before any slot runs, the key is the first argument. Keys added by the slots are for the next emission.
+        uint32_t filtered_list = 0;
+        if constexpr (is_filterable) {
+            if (extension && !ext()->filter_index.entries.empty())
+                filtered_list = ext()->filter_index.find(std::get<0>(std::forward_as_tuple(args...)));
+        }
+
+        // Every list gets the arguments as lvalues, a slot taking one by value can't move it away from the next ones
+        emit<PrefetchDistance>(callbacks, live, args...);
+
+        // Allocated by the first filtered, one-shot or add_on() slot or forwarding link, checked once
+        if (extension) {
+            if (filtered_list) {
+                const internal::SlotList &filtered = slot_list(filtered_list);
+                emit<PrefetchDistance>(filtered.callbacks, filtered.live, args...);
+            }
+
+            if (!ext()->loop_index.entries.empty())
+                emit_on_loops(args...);
+
+            // Slots that emit this signal again don't get the one-shot slots, they're called by the outer emission
+            if (once_list && !is_emitting_once && !slot_list(once_list).callbacks.empty())
+                emit_once(args...);
+
+            // Indexed, slots may add or remove forwarding links
+            const auto &targets = ext()->forwarding.targets;
+            for (size_t i = 0; i < targets.size(); ++i)
+                targets[i]->template emit_all<PrefetchDistance>(args...);
+        }
+
+        if (is_dirty || lists_dirty)
+            compact();
+    }
+
+public:
+    FastSignal() = default;
+
+    explicit FastSignal(std::pmr::memory_resource *mr) : internal::FastSignalBase(mr) {}
+
+    // Like the slots, the extension and its forwarding links are moved but not copied
+    FastSignal(const FastSignal &other) : internal::FastSignalBase(other) {}
+
+    FastSignal& operator=(const FastSignal &other) {
+        internal::FastSignalBase::operator=(other);
+        return *this;
+    }
+
+    FastSignal(FastSignal &&other) noexcept : internal::FastSignalBase(std::move(other)) {
+        relink(&other);
+    }
+
+    FastSignal& operator=(FastSignal &&other) {
+        // Unlinking first would drop the links of a signal assigned to itself
+        if (this == &other)
+            return *this;
+
+        unlink();
+        internal::FastSignalBase::operator=(std::move(other));
+        relink(&other);
+        return *this;
+    }
+
+    ~FastSignal() {
+        unlink();
+    }
+
+    template<auto fun, class ObjType>
+    ConnectionView add(ObjType *obj) {
+        return connect<fun>(obj, 0);
+    }
+
+    ConnectionView add(RetType(fun)(ArgTypes...)) {
+        return connect(fun, 0);
+    }
+
+    // Like add(), but without a connection: nothing is allocated apart from the slot's place in the slot array.
+    // The slot can't be disconnected or blocked, it stays until the signal is destroyed.
+    template<auto fun, class ObjType>
+    void add_permanent(ObjType *obj) {
+        static_assert(std::is_invocable_v<decltype(fun), ObjType*, ArgTypes...>,
+            "Callback must be invocable with the signal's declared parameters");
+        static_assert(std::is_same_v<std::invoke_result_t<decltype(fun), ObjType*, ArgTypes...>, RetType>,
+            "Callback must return the signal's declared return type");
+        static_assert(!std::is_base_of_v<Disconnectable, ObjType>,
+            "Disconnectable objects are disconnected on destruction, connect them with add()");
+
+        push_slot(0, {reinterpret_cast<void*>(obj), member_thunk<fun, ObjType>(), nullptr});
+    }
+
+    void add_permanent(RetType(fun)(ArgTypes...)) {
+        push_slot(0, {nullptr, reinterpret_cast<void*>(fun), nullptr});
+    }
+
+    // Connects fun of every object of [first, last), a range of objects or of pointers to objects,
+    // like add() on each of them. The slot array grows once and the connection records of the whole range
+    // are allocated in a single block, released with the last of them.
+    template<auto fun, typename Iterator>
+    void add_range(Iterator first, Iterator last) {
+        auto object = [](auto &value) {
+            if constexpr (std::is_pointer_v<std::decay_t<decltype(value)>>)
+                return value;
+            else
+                return &value;
+        };
+        using ObjType = std::remove_pointer_t<decltype(object(*first))>;
+        static_assert(std::is_invocable_v<decltype(fun), ObjType*, ArgTypes...>,
+            "Callback must be invocable with the signal's declared parameters");
+        static_assert(std::is_same_v<std::invoke_result_t<decltype(fun), ObjType*, ArgTypes...>, RetType>,
+            "Callback must return the signal's declared return type");
+
+        constexpr bool is_disconnectable = std::is_base_of_v<Disconnectable, ObjType>;
+
+        size_t count = std::distance(first, last);
+        if (count == 0)
+            return;
+
+        reserve_slots(0, count);
+        std::shared_ptr<internal::Connection> block = make_connections(count, is_disconnectable);
+        internal::Connection *conn = block.get();
+        for (; first != last; ++first, ++conn) {
+            ObjType *obj = object(*first);
+            std::shared_ptr<internal::Connection> sp(block, conn);
+            push_slot(0, {reinterpret_cast<void*>(obj), member_thunk<fun, ObjType>(), sp});
+
+            if constexpr (is_disconnectable)
+                obj->add_connection(std::move(sp));
+        }
+    }
+
+    // Like add(), but a virtual fun is resolved to obj's final override once, here,
+    // and the emission calls it directly instead of going through the thunk and the vtable.
+    // obj must be fully constructed, its dynamic type must not change while connected.
+    // Falls back to add() when the direct call can't be made: fun doesn't take every parameter
+    // by const reference, obj is Disconnectable or the platform's member pointer layout is unknown.
+    template<auto fun, class ObjType>
+    ConnectionView add_devirtualized(ObjType *obj) {
+        return connect_devirtualized<fun>(obj, 0);
+    }
+
+    // Filtered slots are only called when the first argument of the emission equals key.
+    // Slots are indexed by key, an emission only walks the slots of its key, after the unfiltered slots.
+    template<auto fun, class ObjType>
+    ConnectionView add_filtered(const FilterKey &key, ObjType *obj) {
+        return connect<fun>(obj, filter_list(key));
+    }
+
+    ConnectionView add_filtered(const FilterKey &key, RetType(fun)(ArgTypes...)) {
+        return connect(fun, filter_list(key));
+    }
+
+    // One-shot slots are disconnected as they are called, on the next emission.
+    // They are kept apart from the other slots and dropped together once the emission is done,
+    // so they don't dirty the signal the way disconnecting from inside the slot does.
+    template<auto fun, class ObjType>
+    ConnectionView add_once(ObjType *obj) {
+        return connect<fun>(obj, once_slot_list(get_extension()));
+    }
+
+    ConnectionView add_once(RetType(fun)(ArgTypes...)) {
+        return connect(fun, once_slot_list(get_extension()));
+    }
+
+    // Slots run on loop's thread. An emission on that thread calls them inline, after the unfiltered
+    // and filtered slots. An emission on another thread copies the arguments and posts the loop's slots
+    // as a single task, the loop is woken up once for all of them and calls the slots still connected.
+    // The signal itself is not thread-safe: connecting, disconnecting and emitting must be synchronized
+    // as usual, only the delivery happens on the loop's thread. The loop must outlive the connections.
+    template<auto fun, class ObjType>
+    ConnectionView add_on(EventLoop &loop, ObjType *obj) {
+        return connect<fun>(obj, loop_list(loop));
+    }
+
+    ConnectionView add_on(EventLoop &loop, RetType(fun)(ArgTypes...)) {
+        return connect(fun, loop_list(loop));
+    }
+
+    // Every emission of this signal also emits target, after this signal's slots.
+    // The target's slots are walked directly by the emission, there is no intermediate slot.
+    // Links follow both signals when they are moved and are removed when either is destroyed.
+    // Returns false if target already receives this signal's emissions, including through a cycle.
+    bool forward_to(FastSignal &target) {
+        if (forwards_to(&target) || target.forwards_to(this))
+            return false;
+
+        get_extension().forwarding.targets.push_back(&target);
+        target.get_extension().forwarding.sources.push_back(this);
+        return true;
+    }
+
+    void stop_forwarding(FastSignal &target) {
+        if (!extension || !target.extension)
+            return;
+
+        ForwardLinks::remove(ext()->forwarding.targets, &target);
+        ForwardLinks::remove(target.ext()->forwarding.sources, this);
+    }
+
+    // The slot lists, the connection records and the indexes of the filtered slots, event loops and forwarding links
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage = base_memory_usage();
+        if (const Extension *extended = ext()) {
+            usage.heap_bytes += sizeof(Extension) +
+                extended->filter_index.entries.capacity() * sizeof(extended->filter_index.entries[0]) +
+                extended->loop_index.entries.capacity() * sizeof(extended->loop_index.entries[0]) +
+                (extended->forwarding.targets.capacity() + extended->forwarding.sources.capacity()) * sizeof(FastSignal*);
+        }
+        return usage;
+    }
+
+    // TODO(victor);
+    // void add(CallbackType fun) {
+    //     (void)fun;
+    // }
+
+    template<typename... ActualArgs>
+    void operator()(ActualArgs&&... args) const {
+        // TODO(victor) - check if the parameters match the signature of the callback
+        emit_all<0>(std::forward<ActualArgs>(args)...);
+    }
+
+    // Same as operator(), but prefetches the object of the slot PrefetchDistance places ahead of
+    // the one being called. Helps when the observers are scattered across the heap and the slots
+    // are too cheap to hide the cache misses, the right distance depends on the cost of the slots.
+    // Lists with disconnected or blocked slots are walked without prefetching.
+    template<size_t PrefetchDistance = 8, typename... ActualArgs>
+    void emit_prefetched(ActualArgs&&... args) const {
+        static_assert(PrefetchDistance > 0, "Use operator() to emit without prefetching");
+        emit_all<PrefetchDistance>(std::forward<ActualArgs>(args)...);
+    }
+
+#ifdef FASTSIGNAL_TEST
+    size_t actual_count() const {
+        return callbacks.size();
+    }
+#endif
+};
+
+// Connects obj to several signals, funs[i] to signals[i], with one connection record shared by all the slots
+// and allocated at once. The returned view, and the destruction of a Disconnectable obj, disconnect all of them
+// in a single operation, and a Disconnectable obj keeps a single connection for them.
+// The record is allocated from the first signal's memory resource.
+template<auto... funs, class ObjType, typename... Signals>
+ConnectionView connect_all(ObjType *obj, Signals&... signals)
+{
+    static_assert(sizeof...(Signals) > 0, "connect_all needs at least one signal");
+    static_assert(sizeof...(funs) == sizeof...(Signals), "connect_all needs one function per signal");
+
+    constexpr size_t count = sizeof...(Signals);
+    using Record = std::array<internal::Connection, count>;
+
+    auto &first = std::get<0>(std::tie(signals...));
+    std::shared_ptr<Record> record =
+        std::allocate_shared<Record>(std::pmr::polymorphic_allocator<Record>(first.resource()));
+    (*record)[0].record_count = count;
+
+    size_t i = 0;
+    ((signals.template connect_shared<funs>(obj, std::shared_ptr<internal::Connection>(record, &(*record)[i]), i == 0),
+        ++i), ...);
+
+    return ConnectionView(std::shared_ptr<internal::Connection>(record, record->data()));
+}
+
+// Events are identified by a small integer id.
+// Dispatch is an index into a table of signals followed by the usual slot walk, nothing is hashed.
+// The table is a deque, growing it for a new id doesn't move the signals, a slot can connect to a new event
+// while its own event is emitted.
+template<typename RetType, typename... ArgTypes>
+class EventBus<RetType(ArgTypes...)>
+{
+    using SignalType = FastSignal<RetType(ArgTypes...)>;
+
+    std::pmr::deque<SignalType> signals;
+
+public:
+    explicit EventBus(size_t event_count = 0, std::pmr::memory_resource *mr = std::pmr::get_default_resource()) :
+        signals(mr) {
+        reserve(event_count);
+    }
+
+    void reserve(size_t event_count) {
+        while (signals.size() < event_count)
+            signals.emplace_back(signals.get_allocator().resource());
+    }
+
+    SignalType& operator[](size_t id) {
+        if (id >= signals.size())
+            reserve(id + 1);
+        return signals[id];
+    }
+
+    template<auto fun, class ObjType>
+    ConnectionView add(size_t id, ObjType *obj) {
+        return (*this)[id].template add<fun>(obj);
+    }
+
+    ConnectionView add(size_t id, RetType(fun)(ArgTypes...)) {
+        return (*this)[id].add(fun);
+    }
+
+    template<typename... ActualArgs>
+    void operator()(size_t id, ActualArgs&&... args) const {
+        if (id >= signals.size())
+            return;
+        signals[id](std::forward<ActualArgs>(args)...);
+    }
+
+    size_t size() const {
+        return signals.size();
+    }
+};
+
+// Events are identified by their type, every event type has its own signal taking the event by const reference.
+// The signal of an event is resolved at compile time.
+template<typename... Events>
+class TypedEventBus
+{
+    template<typename Event>
+    using SignalType = FastSignal<void(const Event&)>;
+
+    std::tuple<SignalType<Events>...> signals;
+
+    template<typename Event>
+    static constexpr bool has_event = (std::is_same_v<Event, Events> || ...);
+
+public:
+    TypedEventBus() = default;
+
+    explicit TypedEventBus(std::pmr::memory_resource *mr) : signals(SignalType<Events>(mr)...) {}
+
+    template<typename Event>
+    SignalType<Event>& get() {
+        static_assert(has_event<Event>, "Event is not part of the bus");
+        return std::get<SignalType<Event>>(signals);
+    }
+
+    template<typename Event, auto fun, class ObjType>
+    ConnectionView add(ObjType *obj) {
+        return get<Event>().template add<fun>(obj);
+    }
+
+    template<typename Event>
+    ConnectionView add(void(fun)(const Event&)) {
+        return get<Event>().add(fun);
+    }
+
+    template<typename Event>
+    void operator()(const Event &event) const {
+        static_assert(has_event<Event>, "Event is not part of the bus");
+        std::get<SignalType<Event>>(signals)(event);
+    }
+};
 
 namespace internal {
 
-struct Callback
+class CoalescingSignalBase
 {
-    void *obj = nullptr;
-    void *fun = nullptr;
-    std::shared_ptr<Connection> conn = nullptr;
-};
+    friend class fastsignal::CoalescingGroup;
 
-struct Connection
-{
-    FastSignalBase *sig = nullptr;
-    int index = -1;
-    int ref_count = 1;
-    bool is_disconnectable = false;
+protected:
+    CoalescingGroup *group = nullptr;
+    bool pending = false;
 
-    Connection(FastSignalBase *sig, int index, bool is_disconnectable) :
-        sig(sig), index(index), is_disconnectable(is_disconnectable) {}
+    CoalescingSignalBase(CoalescingGroup *group) : group(group) {}
 
-    Connection(const Connection &other) = delete;
-    Connection &operator=(const Connection &other) = delete;
-    Connection(Connection &&other) = delete;
-    Connection &operator=(Connection &&other) = delete;
+    inline void mark_pending();
+    inline void unmark_pending();
+
+    // Emits the stored arguments, the pending flag is already cleared
+    virtual void emit_pending() = 0;
+
+public:
+    CoalescingSignalBase(const CoalescingSignalBase&) = delete;
+    CoalescingSignalBase& operator=(const CoalescingSignalBase&) = delete;
+
+    virtual ~CoalescingSignalBase() = default;
+
+    void flush() {
+        if (!pending)
+            return;
 
-    void set_sig(FastSignalBase *sig) {
-        this->sig = sig;
+        unmark_pending();
+        emit_pending();
     }
 
-    inline void disconnect();
-    inline void update_sig_obj(Disconnectable *obj);
+    bool is_pending() const {
+        return pending;
+    }
 };
 
-class FastSignalBase
+} // namespace internal
+
+// Flushes all the pending coalescing signals attached to it, in the order they became pending.
+// The group must outlive its signals.
+class CoalescingGroup
 {
-protected:
-    mutable std::vector<Callback> callbacks;
-    
-    size_t callback_count = 0;
-    mutable bool is_dirty = false;
+    friend class internal::CoalescingSignalBase;
+
+    std::vector<internal::CoalescingSignalBase*> pending;
+    std::vector<internal::CoalescingSignalBase*> flushing;
+    bool is_flushing = false;
 
 public:
-    FastSignalBase() = default;
+    CoalescingGroup() = default;
 
-    FastSignalBase(const FastSignalBase&) {}
-    FastSignalBase& operator=(const FastSignalBase&) { return *this; }
+    CoalescingGroup(const CoalescingGroup&) = delete;
+    CoalescingGroup& operator=(const CoalescingGroup&) = delete;
 
-    FastSignalBase(FastSignalBase &&other) :
-        callbacks(std::move(other.callbacks)), callback_count(other.callback_count),
-            is_dirty(other.is_dirty) {
-        other.callback_count = 0;
+    void flush() {
+        if (is_flushing)
+            return;
 
-        for (auto &cb : callbacks) {
-            if (!cb.conn)
+        // Signals emitted again by the slots are flushed on the next call
+        is_flushing = true;
+        flushing.swap(pending);
+        for (size_t i = 0; i < flushing.size(); ++i) {
+            internal::CoalescingSignalBase *sig = flushing[i];
+            // Destroyed by a slot during this flush
+            if (!sig)
                 continue;
-            cb.conn->set_sig(this);
+
+            sig->pending = false;
+            sig->emit_pending();
         }
+        flushing.clear();
+        is_flushing = false;
     }
 
-    FastSignalBase& operator=(FastSignalBase &&other) {
-        callbacks = std::move(other.callbacks);
-        callback_count = other.callback_count;
-        is_dirty = other.is_dirty;
-        other.callback_count = 0;
+    size_t pending_count() const {
+        return pending.size();
+    }
+};
 
-        for (auto &cb : callbacks) {
-            if (!cb.conn)
-                continue;
-            cb.conn->set_sig(this);
-        }
+namespace internal {
 
-        return *this;
+inline void CoalescingSignalBase::mark_pending()
+{
+    pending = true;
+    if (group)
+        group->pending.push_back(this);
+}
+
+inline void CoalescingSignalBase::unmark_pending()
+{
+    pending = false;
+    if (!group)
+        return;
+
+    auto &list = group->pending;
+    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+    std::replace(group->flushing.begin(), group->flushing.end(), this, static_cast<CoalescingSignalBase*>(nullptr));
+}
+
+} // namespace internal
+
+// Calling the signal only stores the latest arguments (by value) and marks the signal pending.
+// flush(), or a flush of its group, emits once with the stored arguments.
+template<typename RetType, typename... ArgTypes>
+class CoalescingSignal<RetType(ArgTypes...)> final : public internal::CoalescingSignalBase
+{
+    using SignalType = FastSignal<RetType(ArgTypes...)>;
+    using ArgsType = std::tuple<std::decay_t<ArgTypes>...>;
+
+    SignalType signal;
+    std::optional<ArgsType> latest;
+
+protected:
+    void emit_pending() override {
+        // Moved out first, so slots can call the signal again
+        ArgsType args = std::move(*latest);
+        latest.reset();
+        std::apply(signal, args);
     }
 
-    virtual ~FastSignalBase() {
-        for (auto &cb : callbacks) {
-            if (!cb.conn)
-                continue;
-            cb.conn->set_sig(nullptr);
-            cb.conn = nullptr;
-        }
+public:
+    CoalescingSignal() : internal::CoalescingSignalBase(nullptr) {}
+    explicit CoalescingSignal(CoalescingGroup &group) : internal::CoalescingSignalBase(&group) {}
+
+    ~CoalescingSignal() {
+        if (pending)
+            unmark_pending();
     }
 
-    void update_sig_obj(int index, Disconnectable *obj) {
-        callbacks[index].obj = obj;
+    template<auto fun, class ObjType>
+    ConnectionView add(ObjType *obj) {
+        return signal.template add<fun>(obj);
     }
 
-    void dirty(int index) {
-        is_dirty = true;
-        --callback_count;
+    ConnectionView add(RetType(fun)(ArgTypes...)) {
+        return signal.add(fun);
+    }
+
+    template<typename... ActualArgs>
+    void operator()(ActualArgs&&... args) {
+        if (latest)
+            *latest = std::forward_as_tuple(std::forward<ActualArgs>(args)...);
+        else
+            latest.emplace(std::forward<ActualArgs>(args)...);
 
-        callbacks[index].fun = nullptr;
-        callbacks[index].obj = nullptr;
+        if (!pending)
+            mark_pending();
     }
 
     size_t count() const {
-        return callback_count;
+        return signal.count();
     }
 };
 
-inline void Connection::disconnect()
+namespace internal {
+
+template<typename Signature>
+struct SignatureTraits;
+
+template<typename RetType, typename... ArgTypes>
+struct SignatureTraits<RetType(ArgTypes...)>
 {
-    if (!sig)
-        return;
+    using Args = std::tuple<ArgTypes...>;
+    using ArgRefs = std::tuple<const ArgTypes&...>;
+    using Thunk = RetType(*)(void*, const ArgTypes&...);
 
-    sig->dirty(index);
-    sig = nullptr;
-}
+    template<auto fun, class ObjType>
+    static constexpr bool is_slot = std::is_invocable_v<decltype(fun), ObjType*, ArgTypes...>;
 
-inline void Connection::update_sig_obj(Disconnectable *obj) {
-    if (!sig)
-        return;
-    sig->update_sig_obj(index, obj);
-}
+    template<auto fun, class ObjType>
+    static RetType call(void *obj, const ArgTypes&... args) {
+        return (reinterpret_cast<ObjType*>(obj)->*fun)(args...);
+    }
+};
 
 } // namespace internal
 
-class Disconnectable
+// The slots of several signals fired together for the same observers, e.g. the signals of a subject.
+// An observer is connected to every signal of the group at once and has a single slot holding all its handlers.
+// operator() emits every signal of the group in one walk, calling all the handlers of an observer
+// before moving to the next one, so each observer is loaded once instead of once per signal.
+// emit<I>() emits a single signal of the group.
+template<typename... Signatures>
+class SignalGroup final : public internal::FastSignalBase
 {
-    std::vector<std::weak_ptr<internal::Connection>> connections;
+    using ArgRefs = std::tuple<typename internal::SignatureTraits<Signatures>::ArgRefs...>;
+    using Thunks = std::tuple<typename internal::SignatureTraits<Signatures>::Thunk...>;
 
-    template<typename Signature>
-    friend class FastSignal;
-    friend class internal::FastSignalBase;
+    // One per observer type and handlers, the slot's function points to it
+    struct SlotTable
+    {
+        void (*combined)(void*, const ArgRefs&);
+        Thunks thunks;
+    };
 
-    void add_connection(std::shared_ptr<internal::Connection> conn) {
-        connections.emplace_back(conn);
+    template<class ObjType, auto... funs>
+    struct Slot
+    {
+        template<size_t I>
+        static void call(void *obj, const ArgRefs &args) {
+            constexpr auto fun = std::get<I>(std::make_tuple(funs...));
+            std::apply([obj](auto&&... signal_args) {
+                (reinterpret_cast<ObjType*>(obj)->*fun)(signal_args...);
+            }, std::get<I>(args));
+        }
+
+        template<size_t... Is>
+        static void call_all(void *obj, const ArgRefs &args, std::index_sequence<Is...>) {
+            (call<Is>(obj, args), ...);
+        }
+
+        static void combined(void *obj, const ArgRefs &args) {
+            call_all(obj, args, std::index_sequence_for<Signatures...>());
+        }
+
+        static constexpr SlotTable table = {&combined,
+            Thunks(&internal::SignatureTraits<Signatures>::template call<funs, ObjType>...)};
+    };
+
+    static const SlotTable& table(const internal::Callback &cb) {
+        return *static_cast<const SlotTable*>(cb.fun);
     }
 
 public:
+    SignalGroup() = default;
+    explicit SignalGroup(std::pmr::memory_resource *mr) : internal::FastSignalBase(mr) {}
 
-    Disconnectable() = default;
+    // One handler per signal of the group, in the order of the signatures
+    template<auto... funs, class ObjType>
+    ConnectionView add(ObjType *obj) {
+        static_assert(sizeof...(funs) == sizeof...(Signatures),
+            "SignalGroup::add needs one callback per signal of the group");
+        static_assert((internal::SignatureTraits<Signatures>::template is_slot<funs, ObjType> && ...),
+            "Callbacks must be invocable with the parameters of their signal");
 
-    Disconnectable(const Disconnectable&) {};
-    Disconnectable& operator=(const Disconnectable&) { return *this; };
+        constexpr bool is_disconnectable = std::is_base_of_v<Disconnectable, ObjType>;
 
-    Disconnectable(Disconnectable &&other) : connections(std::move(other.connections)) {
-        for (auto &conn : connections) {
-            std::shared_ptr<internal::Connection> sp = conn.lock();
-            if (!sp)
-                continue;
-            sp->update_sig_obj(this);
-        }
-    };
-    Disconnectable& operator=(Disconnectable &&other) {
-        connections = std::move(other.connections);
-        for (auto &conn : connections) {
-            std::shared_ptr<internal::Connection> sp = conn.lock();
-            if (!sp)
+        std::shared_ptr<internal::Connection> conn = make_connection(is_disconnectable);
+        push_slot(0, {reinterpret_cast<void*>(obj),
+            const_cast<void*>(static_cast<const void*>(&Slot<ObjType, funs...>::table)), conn});
+
+        if constexpr (is_disconnectable)
+            obj->add_connection(conn);
+
+        return ConnectionView(conn);
+    }
+
+    // Emits every signal of the group, one tuple of arguments per signal
+    void operator()(const typename internal::SignatureTraits<Signatures>::Args&... args) const {
+        if (blocked)
+            return;
+
+        ArgRefs refs(args...);
+        // Indexed, a slot may add observers and reallocate the slots. Observers added by the slots are for the next emission.
+        size_t size = callbacks.size();
+        for (size_t i = 0; i < size; ++i) {
+            const internal::Callback &cb = callbacks[i];
+            if (cb.fun == nullptr)
                 continue;
-            sp->update_sig_obj(this);
+            table(cb).combined(cb.obj, refs);
         }
-        return *this;
-    };
 
-    virtual ~Disconnectable() {
-        for (auto &conn : connections) {
-            std::shared_ptr<internal::Connection> sp = conn.lock();
-            if (!sp)
+        if (is_dirty)
+            compact();
+    }
+
+    // Emits the I-th signal of the group only
+    template<size_t I, typename... ActualArgs>
+    void emit(ActualArgs&&... args) const {
+        static_assert(I < sizeof...(Signatures), "SignalGroup has no such signal");
+
+        if (blocked)
+            return;
+
+        size_t size = callbacks.size();
+        for (size_t i = 0; i < size; ++i) {
+            const internal::Callback &cb = callbacks[i];
+            if (cb.fun == nullptr)
                 continue;
-            sp->disconnect();
-            conn.reset();
+            std::get<I>(table(cb).thunks)(cb.obj, std::forward<ActualArgs>(args)...);
         }
+
+        if (is_dirty)
+            compact();
     }
 };
 
-class ConnectionView
+// A signal emitted by one thread and delivered on another, through a fixed ring of Capacity emissions.
+// The emission constructs the arguments in place in the next cell of the ring: no allocation, no boxing.
+// The consumer thread calls process(), which emits the pending arguments through a regular FastSignal.
+// Arguments are stored by value, slots taking a reference get a reference to the copy in the ring.
+// Exactly one thread may emit and one thread may call process(). Connect the slots on the consumer thread.
+template<typename RetType, typename... ArgTypes, size_t Capacity>
+class SpscSignal<RetType(ArgTypes...), Capacity>
 {
-    std::weak_ptr<internal::Connection> connection;
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t MASK = Capacity - 1;
+
+    using Arguments = std::tuple<std::decay_t<ArgTypes>...>;
+
+    // A cell per cache line at least, the producer and the consumer don't share lines
+    struct alignas(CACHE_LINE_SIZE) Cell
+    {
+        alignas(Arguments) unsigned char storage[sizeof(Arguments)];
+
+        Arguments* arguments() {
+            return std::launder(reinterpret_cast<Arguments*>(storage));
+        }
+    };
+
+    FastSignal<RetType(ArgTypes...)> signal;
+    std::unique_ptr<Cell[]> cells;
+
+    // Written by the producer, with the consumer's position as the producer last saw it
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+
+    // Written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
 
 public:
-    ConnectionView(std::shared_ptr<internal::Connection> connection = nullptr) : connection(connection) {}
+    SpscSignal() : cells(new Cell[Capacity]) {}
 
-    ~ConnectionView() {
-        connection.reset();
+    SpscSignal(const SpscSignal&) = delete;
+    SpscSignal& operator=(const SpscSignal&) = delete;
+
+    // Pending emissions are dropped
+    ~SpscSignal() {
+        size_t end = tail.load(std::memory_order_acquire);
+        for (size_t i = head.load(std::memory_order_relaxed); i != end; ++i)
+            cells[i & MASK].arguments()->~Arguments();
     }
 
-    ConnectionView(const ConnectionView &other) {
-        connection = other.connection;
+    template<auto fun, class ObjType>
+    ConnectionView add(ObjType *obj) {
+        return signal.template add<fun>(obj);
     }
 
-    ConnectionView& operator=(const ConnectionView &other) {
-        connection = other.connection;
-        return *this;
+    ConnectionView add(RetType(fun)(ArgTypes...)) {
+        return signal.add(fun);
     }
 
-    ConnectionView(ConnectionView &&other) : connection(other.connection) {
-        other.connection.reset();
+    // Producer, returns false if the ring is full
+    template<typename... ActualArgs>
+    bool try_emit(ActualArgs&&... args) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head == Capacity) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head == Capacity)
+                return false;
+        }
+
+        new (cells[position & MASK].storage) Arguments(std::forward<ActualArgs>(args)...);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
     }
 
-    ConnectionView& operator=(ConnectionView &&other) {
-        connection = other.connection;
-        other.connection.reset();
-        return *this;
+    // Producer, waits for the consumer while the ring is full
+    template<typename... ActualArgs>
+    void operator()(ActualArgs&&... args) {
+        // The arguments are only consumed by the call that succeeds
+        while (!try_emit(std::forward<ActualArgs>(args)...))
+            std::this_thread::yield();
+    }
+
+    // Consumer, emits up to max pending emissions in order, returns how many were emitted
+    size_t process(size_t max = SIZE_MAX) {
+        // One load of the producer's position per batch
+        size_t position = head.load(std::memory_order_relaxed);
+        size_t end = tail.load(std::memory_order_acquire);
+
+        size_t count = 0;
+        while (position != end && count < max) {
+            Arguments *arguments = cells[position & MASK].arguments();
+            std::apply([this](auto&... args) { signal(args...); }, *arguments);
+            arguments->~Arguments();
+
+            head.store(++position, std::memory_order_release);
+            ++count;
+        }
+        return count;
     }
 
+    size_t count() const {
+        return signal.count();
+    }
+};
+
+namespace internal {
+
+// Threads are numbered in the order they first connect to a ShardedSignal, the number picks their shard
+inline size_t thread_shard() {
+    static std::atomic<size_t> thread_count{0};
+    thread_local size_t index = thread_count.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace internal
+
+// A slot of a ShardedSignal, disconnects under the lock of the slot's shard.
+// Like a ConnectionView it can outlive the signal, and it doesn't disconnect on destruction.
+class ShardedConnection
+{
+    std::shared_ptr<std::recursive_mutex> mutex;
+    ConnectionView view;
+
+public:
+    ShardedConnection() = default;
+
+    ShardedConnection(std::shared_ptr<std::recursive_mutex> mutex, ConnectionView view) :
+        mutex(std::move(mutex)), view(std::move(view)) {}
+
+    // From any thread, a slot may disconnect itself
     void disconnect() {
-        std::shared_ptr<internal::Connection> conn = connection.lock();
-        if (!conn)
+        if (!mutex)
             return;
 
-        conn->disconnect();
-        connection.reset();
+        {
+            std::lock_guard<std::recursive_mutex> lock(*mutex);
+            view.disconnect();
+        }
+        mutex.reset();
     }
 };
 
+// A signal that many threads connect to and disconnect from, split in shards that each have their own FastSignal
+// and their own lock. A thread always connects to the same shard, threads on different shards don't contend
+// on connect and disconnect. The emission walks all the shards, locking each one while calling its slots:
+// slots of different shards are called in shard order, not in connection order.
+// Slots may connect, disconnect or emit again from inside the emission, the shard locks are recursive.
+// Disconnectable observers aren't supported, their destructor would disconnect without the shard's lock.
 template<typename RetType, typename... ArgTypes>
-class FastSignal<RetType(ArgTypes...)> final : public internal::FastSignalBase
+class ShardedSignal<RetType(ArgTypes...)>
 {
-    using CallbackType = std::function<RetType(ArgTypes...)>;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
 
-public:
-    template<auto fun, class ObjType>
-    ConnectionView add(ObjType *obj) {
-        using FunType = decltype(fun);
-        static_assert(std::is_invocable_v<FunType, ObjType*, ArgTypes...>,
-            "Callback must be invocable with the signal's declared parameters");
-        static_assert(std::is_same_v<std::invoke_result_t<FunType, ObjType*, ArgTypes...>, RetType>,
-            "Callback must return the signal's declared return type");
+    // Shared with the connections, which may outlive the signal
+    struct alignas(CACHE_LINE_SIZE) Lock
+    {
+        std::recursive_mutex mutex;
+    };
 
-        constexpr bool is_disconnectable = std::is_base_of_v<Disconnectable, ObjType>;
+    static std::shared_ptr<std::recursive_mutex> make_lock() {
+        auto lock = std::make_shared<Lock>();
+        return {lock, &lock->mutex};
+    }
 
-        std::shared_ptr<internal::Connection> conn = std::make_shared<internal::Connection>(this, callbacks.size(), is_disconnectable);
-        callbacks.push_back({reinterpret_cast<void*>(obj),
-            reinterpret_cast<void*>(+[](void *obj, const ArgTypes&... args) -> RetType {
-                (reinterpret_cast<ObjType*>(obj)->*fun)(args...);
-            }), conn});
-        ++callback_count;
+    // Shards and their locks don't share cache lines, connecting to one doesn't invalidate the others
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        std::shared_ptr<std::recursive_mutex> mutex = make_lock();
+        // Set by a connection, cleared by an emission that leaves the shard empty.
+        // Read without the lock, emissions skip inactive shards without locking them.
+        std::atomic<bool> active{false};
+        FastSignal<RetType(ArgTypes...)> signal;
+    };
 
-        if constexpr (is_disconnectable)
-            obj->add_connection(conn);
+    size_t num_shards;
+    std::unique_ptr<Shard[]> shards;
 
-        return ConnectionView(conn);
+    template<typename Connect>
+    ShardedConnection connect(Connect &&connect) {
+        Shard &shard = shards[internal::thread_shard() % num_shards];
+        std::lock_guard<std::recursive_mutex> lock(*shard.mutex);
+        ConnectionView view = connect(shard.signal);
+        if (!shard.active.load(std::memory_order_relaxed))
+            shard.active.store(true, std::memory_order_relaxed);
+        return {shard.mutex, std::move(view)};
     }
 
-    ConnectionView add(RetType(fun)(ArgTypes...)) {
-        std::shared_ptr<internal::Connection> conn = std::make_shared<internal::Connection>(this, callbacks.size(), false);
-        callbacks.push_back({nullptr, reinterpret_cast<void*>(fun), conn});
-        ++callback_count;
-        return ConnectionView(conn);
+public:
+    // One shard per hardware thread by default
+    explicit ShardedSignal(size_t shard_count = std::thread::hardware_concurrency()) :
+        num_shards(std::max<size_t>(shard_count, 1)), shards(new Shard[num_shards]) {}
+
+    ShardedSignal(const ShardedSignal&) = delete;
+    ShardedSignal& operator=(const ShardedSignal&) = delete;
+
+    template<auto fun, class ObjType>
+    ShardedConnection add(ObjType *obj) {
+        static_assert(!std::is_base_of_v<Disconnectable, ObjType>,
+            "Disconnectable objects can't connect to a ShardedSignal, disconnect through the ShardedConnection");
+        return connect([obj](FastSignal<RetType(ArgTypes...)> &signal) {
+            return signal.template add<fun>(obj);
+        });
     }
 
-    // TODO(victor);
-    // void add(CallbackType fun) {
-    //     (void)fun;
-    // }
+    ShardedConnection add(RetType(fun)(ArgTypes...)) {
+        return connect([fun](FastSignal<RetType(ArgTypes...)> &signal) {
+            return signal.add(fun);
+        });
+    }
 
     template<typename... ActualArgs>
     void operator()(ActualArgs&&... args) const {
-        // TODO(victor) - check if the parameters match the signature of the callback
-        for (auto &cb : callbacks) {
-            if (cb.fun == nullptr)
+        for (size_t i = 0; i < num_shards; ++i) {
+            Shard &shard = shards[i];
+            if (!shard.active.load(std::memory_order_relaxed))
                 continue;
 
-            if (cb.obj)
-                reinterpret_cast<RetType(*)(void*, const ArgTypes&...)>(cb.fun)(cb.obj, std::forward<ActualArgs>(args)...);
-            else
-                reinterpret_cast<RetType(*)(ArgTypes...)>(cb.fun)(std::forward<ActualArgs>(args)...);
-        }
-
-        if (!is_dirty)
-            return;
-
-        size_t size = 0;
-        for (size_t i = 0; i < callbacks.size(); i++) {
-            if (callbacks[i].fun == nullptr) {
-                callbacks[i].conn->set_sig(nullptr);
-                callbacks[i].conn = nullptr;
-            } else {
-                callbacks[size] = callbacks[i];
-                callbacks[size].conn->index = size;
-                size++;
-            }
+            std::lock_guard<std::recursive_mutex> lock(*shard.mutex);
+            // Every shard gets the same arguments, none is moved from
+            shard.signal(args...);
+            // The emission compacted the shard, it's skipped until the next connection
+            if (shard.signal.count() == 0)
+                shard.active.store(false, std::memory_order_relaxed);
         }
+    }
 
-        is_dirty = false;
-        callbacks.resize(size);
+    size_t shard_count() const {
+        return num_shards;
     }
 
-#ifdef FASTSIGNAL_TEST
-    size_t actual_count() const {
-        return callbacks.size();
+    // Locks the shards one after the other
+    size_t count() const {
+        size_t total = 0;
+        for (size_t i = 0; i < num_shards; ++i) {
+            std::lock_guard<std::recursive_mutex> lock(*shards[i].mutex);
+            total += shards[i].signal.count();
+        }
+        return total;
     }
-#endif
 };
 
 } // namespace fastsignal
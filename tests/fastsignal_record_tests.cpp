@@ -0,0 +1,180 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "fastsignal.hpp"
+
+using namespace fastsignal;
+
+#ifndef FASTSIGNAL_RECORD
+#error "fastsignal_record_tests must be built with FASTSIGNAL_RECORD"
+#endif
+
+struct Receiver {
+    int calls = 0;
+    void on_value(int) { ++calls; }
+};
+
+struct Point {
+    int x;
+    float y;
+};
+
+class FastSignalRecordTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        record::stop();
+    }
+
+    // Round trip through the binary format
+    static std::vector<record::Event> events()
+    {
+        std::stringstream stream;
+        EXPECT_TRUE(record::write(stream));
+        std::vector<record::Event> events;
+        EXPECT_TRUE(record::read(stream, events));
+        return events;
+    }
+
+    template<typename T>
+    static T arg(const record::Event &event, size_t offset = 0)
+    {
+        T value;
+        std::memcpy(&value, event.args.data() + offset, sizeof(T));
+        return value;
+    }
+};
+
+TEST_F(FastSignalRecordTest, test_record_connect_emit_disconnect)
+{
+    FastSignal<void(int)> sig;
+    Receiver receivers[2];
+
+    record::start();
+    auto first = sig.add<&Receiver::on_value>(&receivers[0]);
+    auto second = sig.add<&Receiver::on_value>(&receivers[1]);
+    sig(42);
+    first.disconnect();
+    sig(7);
+    record::stop();
+
+    // Not recorded
+    sig(1);
+    second.disconnect();
+
+    auto log = events();
+    ASSERT_EQ(log.size(), 5u);
+
+    EXPECT_EQ(log[0].type, record::EventType::connect);
+    EXPECT_EQ(log[0].signal, 0u);
+    EXPECT_EQ(log[0].slot, 0u);
+    EXPECT_EQ(log[1].type, record::EventType::connect);
+    EXPECT_EQ(log[1].slot, 1u);
+
+    EXPECT_EQ(log[2].type, record::EventType::emit);
+    ASSERT_EQ(log[2].args.size(), sizeof(int));
+    EXPECT_EQ(arg<int>(log[2]), 42);
+
+    EXPECT_EQ(log[3].type, record::EventType::disconnect);
+    EXPECT_EQ(log[3].slot, 0u);
+
+    EXPECT_EQ(log[4].type, record::EventType::emit);
+    EXPECT_EQ(arg<int>(log[4]), 7);
+}
+
+TEST_F(FastSignalRecordTest, test_record_signals_and_destroy)
+{
+    Receiver receiver;
+    FastSignal<void(int)> kept;
+
+    record::start();
+    {
+        FastSignal<void(int)> temporary;
+        temporary.add<&Receiver::on_value>(&receiver);
+        kept.add<&Receiver::on_value>(&receiver);
+        // Moving keeps the anchor, the signal keeps its number
+        FastSignal<void(int)> moved(std::move(temporary));
+        moved(3);
+    }
+    kept(4);
+
+    auto log = events();
+    ASSERT_EQ(log.size(), 5u);
+    EXPECT_EQ(log[0].signal, 0u);
+    EXPECT_EQ(log[1].signal, 1u);
+    EXPECT_EQ(log[2].type, record::EventType::emit);
+    EXPECT_EQ(log[2].signal, 0u);
+    EXPECT_EQ(log[3].type, record::EventType::destroy);
+    EXPECT_EQ(log[3].signal, 0u);
+    EXPECT_EQ(log[4].type, record::EventType::emit);
+    EXPECT_EQ(log[4].signal, 1u);
+}
+
+TEST_F(FastSignalRecordTest, test_record_once_and_permanent)
+{
+    FastSignal<void(int)> sig;
+    Receiver receivers[2];
+
+    record::start();
+    sig.add_permanent<&Receiver::on_value>(&receivers[0]);
+    sig.add_once<&Receiver::on_value>(&receivers[1]);
+    sig(1);
+    sig(2);
+
+    // The one-shot slot is disconnected by the emission that calls it
+    auto log = events();
+    ASSERT_EQ(log.size(), 5u);
+    EXPECT_EQ(log[0].type, record::EventType::connect);
+    EXPECT_EQ(log[1].type, record::EventType::connect);
+    EXPECT_EQ(log[2].type, record::EventType::emit);
+    EXPECT_EQ(log[3].type, record::EventType::disconnect);
+    EXPECT_EQ(log[3].slot, 1u);
+    EXPECT_EQ(log[4].type, record::EventType::emit);
+}
+
+TEST_F(FastSignalRecordTest, test_record_argument_bytes)
+{
+    FastSignal<void(const Point&, const std::string&, double)> sig;
+    sig.add([](const Point&, const std::string&, double) {});
+
+    record::start();
+    sig(Point{1, 2.5f}, "not copied", 0.25f);
+
+    auto log = events();
+    ASSERT_EQ(log.size(), 1u);
+    // Only the trivially copyable parameters, as the declared types: the float is saved as a double
+    ASSERT_EQ(log[0].args.size(), sizeof(Point) + sizeof(double));
+    Point point = arg<Point>(log[0]);
+    EXPECT_EQ(point.x, 1);
+    EXPECT_EQ(point.y, 2.5f);
+    EXPECT_EQ(arg<double>(log[0], sizeof(Point)), 0.25);
+}
+
+TEST_F(FastSignalRecordTest, test_record_restart_and_bad_input)
+{
+    FastSignal<void(int)> sig;
+    Receiver receiver;
+    sig.add<&Receiver::on_value>(&receiver);
+
+    record::start();
+    sig(1);
+    record::start();
+    sig(2);
+    auto log = events();
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_EQ(arg<int>(log[0]), 2);
+
+    std::vector<record::Event> events;
+    std::stringstream empty;
+    EXPECT_FALSE(record::read(empty, events));
+
+    // Cut in the middle of an event
+    std::stringstream stream;
+    record::write(stream);
+    std::string truncated = stream.str();
+    truncated.pop_back();
+    std::stringstream cut(truncated);
+    EXPECT_FALSE(record::read(cut, events));
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "fastsignal.hpp"
+
+using namespace fastsignal;
+
+#ifndef FASTSIGNAL_STATS
+#error "fastsignal_stats_tests must be built with FASTSIGNAL_STATS"
+#endif
+
+struct Recorder : public Disconnectable {
+    int calls = 0;
+    void on_value(int) { ++calls; }
+};
+
+// The counters are process-wide, the tests check how they move
+class FastSignalStatsTest : public ::testing::Test
+{
+protected:
+    stats::Snapshot before;
+
+    void SetUp() override
+    {
+        before = stats::snapshot();
+    }
+
+    stats::Snapshot delta() const
+    {
+        stats::Snapshot now = stats::snapshot();
+        return {now.signals - before.signals, now.slots - before.slots, now.tombstones - before.tombstones,
+            now.compactions - before.compactions, now.reclaimed - before.reclaimed};
+    }
+};
+
+TEST_F(FastSignalStatsTest, test_stats_slots)
+{
+    {
+        FastSignal<void(int)> sig;
+        Recorder recorders[4];
+        std::vector<ConnectionView> connections;
+        for (auto &recorder : recorders)
+            connections.push_back(sig.add<&Recorder::on_value>(&recorder));
+        EXPECT_EQ(delta().signals, 1);
+        EXPECT_EQ(delta().slots, 4);
+
+        connections[0].block();
+        connections[1].disconnect();
+        connections[2].disconnect();
+        EXPECT_EQ(delta().slots, 2);
+        EXPECT_EQ(delta().tombstones, 2);
+
+        sig(1);
+        EXPECT_EQ(delta().tombstones, 0);
+        EXPECT_EQ(delta().compactions, 1);
+        EXPECT_EQ(delta().reclaimed, 2);
+
+        // Leaves a tombstone behind, removed with the signal
+        connections[3].disconnect();
+        EXPECT_EQ(delta().tombstones, 1);
+    }
+
+    stats::Snapshot after = delta();
+    EXPECT_EQ(after.signals, 0);
+    EXPECT_EQ(after.slots, 0);
+    EXPECT_EQ(after.tombstones, 0);
+}
+
+TEST_F(FastSignalStatsTest, test_stats_once_and_moves)
+{
+    {
+        FastSignal<void(int)> sig;
+        Recorder recorder;
+        sig.add_once<&Recorder::on_value>(&recorder);
+        sig.add<&Recorder::on_value>(&recorder);
+        EXPECT_EQ(delta().slots, 2);
+
+        sig(1);
+        EXPECT_EQ(delta().slots, 1);
+        EXPECT_EQ(delta().tombstones, 0);
+
+        std::vector<FastSignal<void(int)>> signals;
+        signals.push_back(std::move(sig));
+        EXPECT_EQ(delta().signals, 2);
+        EXPECT_EQ(delta().slots, 1);
+
+        FastSignal<void(int)> other;
+        other.add<&Recorder::on_value>(&recorder);
+        other = std::move(signals[0]);
+        EXPECT_EQ(delta().slots, 1);
+    }
+
+    stats::Snapshot after = delta();
+    EXPECT_EQ(after.signals, 0);
+    EXPECT_EQ(after.slots, 0);
+    EXPECT_EQ(after.tombstones, 0);
+}
+
+TEST_F(FastSignalStatsTest, test_stats_permanent)
+{
+    {
+        FastSignal<void(int)> sig;
+        sig.add_permanent([](int) {});
+        sig.add(+[](int) {});
+        EXPECT_EQ(delta().slots, 2);
+    }
+
+    stats::Snapshot after = delta();
+    EXPECT_EQ(after.signals, 0);
+    EXPECT_EQ(after.slots, 0);
+}
+
+TEST_F(FastSignalStatsTest, test_stats_teardown)
+{
+    {
+        TeardownScope teardown;
+        auto &sig = teardown.make<FastSignal<void(int)>>();
+        auto &recorders = teardown.make<std::vector<Recorder>>(8);
+        for (auto &recorder : recorders)
+            sig.add<&Recorder::on_value>(&recorder);
+        sig.add(+[](int) {}).disconnect();
+        EXPECT_EQ(delta().slots, 8);
+        EXPECT_EQ(delta().tombstones, 1);
+    }
+
+    stats::Snapshot after = delta();
+    EXPECT_EQ(after.signals, 0);
+    EXPECT_EQ(after.slots, 0);
+    EXPECT_EQ(after.tombstones, 0);
+}
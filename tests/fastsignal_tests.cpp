@@ -1,4 +1,5 @@
 #include <array>
+#include <memory_resource>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h> 
@@ -52,6 +53,28 @@ struct Observer {
 
 struct DisconnectableObserver : public Observer, public Disconnectable {};
 
+struct CountingResource : public std::pmr::memory_resource {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes = 0;
+
+    void *do_allocate(size_t size, size_t alignment) override {
+        ++allocations;
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void *p, size_t size, size_t alignment) override {
+        ++deallocations;
+        bytes -= size;
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
 class FastSignalTest : public ::testing::Test
 {
 protected:
@@ -872,3 +895,1850 @@ TEST_F(FastSignalTest, test_disconnectable_copy_move)
         sig(3);
     }
 }
+
+TEST_F(FastSignalTest, test_signal_block)
+{
+    FastSignal<void(int)> sig;
+    sig.add(set_global_value1);
+    EXPECT_FALSE(sig.is_blocked());
+
+    sig.block();
+    EXPECT_TRUE(sig.is_blocked());
+    EXPECT_EQ(sig.count(), 1);
+    sig(1);
+    EXPECT_EQ(global_value1, 0);
+
+    sig.unblock();
+    EXPECT_FALSE(sig.is_blocked());
+    sig(2);
+    EXPECT_EQ(global_value1, 2);
+
+    // The blocked state moves with the signal
+    sig.block();
+    FastSignal<void(int)> sig2(std::move(sig));
+    EXPECT_TRUE(sig2.is_blocked());
+    sig2(3);
+    EXPECT_EQ(global_value1, 2);
+}
+
+TEST_F(FastSignalTest, test_signal_blocker)
+{
+    FastSignal<void(int)> sig1;
+    FastSignal<void(GlobalParam)> sig2;
+    sig1.add(set_global_value1);
+    sig2.add(set_global_param1);
+
+    {
+        SignalBlocker blocker(sig1, sig2);
+        EXPECT_TRUE(sig1.is_blocked());
+        EXPECT_TRUE(sig2.is_blocked());
+
+        sig1(1);
+        sig2(GlobalParam(1));
+        EXPECT_EQ(global_value1, 0);
+        EXPECT_EQ(global_param1.value, 0);
+
+        {
+            // Nested blocker must not unblock the signals when it goes out of scope
+            SignalBlocker nested(sig1);
+        }
+        EXPECT_TRUE(sig1.is_blocked());
+        sig1(2);
+        EXPECT_EQ(global_value1, 0);
+    }
+
+    EXPECT_FALSE(sig1.is_blocked());
+    EXPECT_FALSE(sig2.is_blocked());
+    sig1(3);
+    sig2(GlobalParam(3));
+    EXPECT_EQ(global_value1, 3);
+    EXPECT_EQ(global_param1.value, 3);
+
+    // A signal that was already blocked stays blocked
+    sig1.block();
+    {
+        SignalBlocker blocker(sig1, sig2);
+    }
+    EXPECT_TRUE(sig1.is_blocked());
+    EXPECT_FALSE(sig2.is_blocked());
+}
+
+TEST_F(FastSignalTest, test_signal_block_connection)
+{
+    FastSignal<void(int)> sig;
+    Observer observer;
+    auto con1 = sig.add<&Observer::set_value>(&observer);
+    auto con2 = sig.add(set_global_value1);
+
+    con1.block();
+    EXPECT_CALL(observer, set_value(1)).Times(0);
+    sig(1);
+    EXPECT_EQ(global_value1, 1);
+
+    // Blocking a slot doesn't disconnect it and doesn't dirty the signal
+    EXPECT_EQ(sig.count(), 2);
+    EXPECT_EQ(sig.actual_count(), 2);
+
+    // The blocked slot survives the compaction triggered by another disconnect
+    con2.disconnect();
+    sig(2);
+    EXPECT_EQ(sig.count(), 1);
+    EXPECT_EQ(sig.actual_count(), 1);
+    EXPECT_EQ(global_value1, 1);
+
+    con1.unblock();
+    EXPECT_CALL(observer, set_value(3));
+    sig(3);
+
+    // Disconnecting a blocked slot removes it
+    con1.block();
+    con1.disconnect();
+    EXPECT_EQ(sig.count(), 0);
+    sig(4);
+    EXPECT_EQ(sig.actual_count(), 0);
+    con1.unblock();
+    sig(5);
+}
+
+TEST_F(FastSignalTest, test_signal_block_disconnectable)
+{
+    FastSignal<void(int)> sig;
+    {
+        DisconnectableObserver observer;
+        auto con = sig.add<&DisconnectableObserver::set_value>(&observer);
+        con.block();
+        EXPECT_CALL(observer, set_value(1)).Times(0);
+        sig(1);
+    }
+
+    // The blocked slot of a destroyed observer is removed like any other
+    EXPECT_EQ(sig.count(), 0);
+    sig(2);
+    EXPECT_EQ(sig.actual_count(), 0);
+}
+
+TEST_F(FastSignalTest, test_signal_memory_resource)
+{
+    CountingResource resource;
+    {
+        FastSignal<void(int)> sig(&resource);
+        EXPECT_EQ(sig.resource(), &resource);
+
+        Observer observer;
+        auto con1 = sig.add<&Observer::set_value>(&observer);
+        auto con2 = sig.add(set_global_value1);
+
+        // Callbacks vector + one record per connection
+        EXPECT_GE(resource.allocations, 3u);
+
+        EXPECT_CALL(observer, set_value(1));
+        sig(1);
+        EXPECT_EQ(global_value1, 1);
+
+        con1.disconnect();
+        sig(2);
+        EXPECT_EQ(global_value1, 2);
+        EXPECT_EQ(sig.count(), 1);
+    }
+    EXPECT_EQ(resource.allocations, resource.deallocations);
+    EXPECT_EQ(resource.bytes, 0);
+
+    {
+        // Moved signals keep their resource, copies get the default one
+        FastSignal<void(int)> sig1(&resource);
+        sig1.add(set_global_value1);
+        FastSignal<void(int)> sig2(std::move(sig1));
+        EXPECT_EQ(sig2.resource(), &resource);
+
+        FastSignal<void(int)> sig3(sig2);
+        EXPECT_EQ(sig3.resource(), std::pmr::get_default_resource());
+    }
+    EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(FastSignalTest, test_signal_memory_resource_disconnectable)
+{
+    struct ArenaDisconnectable : public Disconnectable {
+        int value = 0;
+        ArenaDisconnectable(std::pmr::memory_resource *mr) : Disconnectable(mr) {}
+        void set_value(int x) { value = x; }
+    };
+
+    CountingResource resource;
+    {
+        FastSignal<void(int)> sig(&resource);
+        {
+            ArenaDisconnectable observer(&resource);
+            sig.add<&ArenaDisconnectable::set_value>(&observer);
+            size_t allocations = resource.allocations;
+
+            sig.add<&ArenaDisconnectable::set_value>(&observer);
+            EXPECT_GT(resource.allocations, allocations);
+
+            sig(1);
+            EXPECT_EQ(observer.value, 1);
+        }
+        EXPECT_EQ(sig.count(), 0);
+        sig(2);
+    }
+    EXPECT_EQ(resource.allocations, resource.deallocations);
+
+    {
+        // Everything can live in a monotonic arena
+        std::array<std::byte, 4096> buffer;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+        FastSignal<void(int)> sig(&arena);
+        ArenaDisconnectable observer(&arena);
+        for (int i = 0; i < 10; ++i)
+            sig.add<&ArenaDisconnectable::set_value>(&observer);
+        sig.add(set_global_value1);
+        sig(3);
+        EXPECT_EQ(observer.value, 3);
+        EXPECT_EQ(global_value1, 3);
+    }
+}
+
+TEST_F(FastSignalTest, test_event_bus)
+{
+    EventBus<void(int)> bus(2);
+    EXPECT_EQ(bus.size(), 2);
+
+    Observer observer;
+    bus.add(0, set_global_value1);
+    auto con = bus.add<&Observer::set_value>(1, &observer);
+
+    bus(0, 1);
+    EXPECT_EQ(global_value1, 1);
+
+    EXPECT_CALL(observer, set_value(2));
+    bus(1, 2);
+    EXPECT_EQ(global_value1, 1);
+
+    // Emitting an unknown event does nothing
+    bus(10, 3);
+    EXPECT_EQ(bus.size(), 2);
+
+    // Connecting to a new id grows the table, existing connections are kept
+    bus.add(100, set_global_value2);
+    EXPECT_EQ(bus.size(), 101);
+    EXPECT_EQ(bus[0].count(), 1);
+    EXPECT_EQ(bus[1].count(), 1);
+
+    bus(100, 4);
+    EXPECT_EQ(global_value2, 4);
+    EXPECT_EQ(global_value1, 1);
+
+    con.disconnect();
+    EXPECT_CALL(observer, set_value(5)).Times(0);
+    bus(1, 5);
+    EXPECT_EQ(bus[1].count(), 0);
+}
+
+TEST_F(FastSignalTest, test_event_bus_disconnectable)
+{
+    EventBus<void(int)> bus;
+    {
+        DisconnectableObserver observer;
+        bus.add<&DisconnectableObserver::set_value>(3, &observer);
+
+        // Growing the table must keep the Disconnectable's connection valid
+        bus.add(64, set_global_value1);
+
+        EXPECT_CALL(observer, set_value(1));
+        bus(3, 1);
+    }
+    EXPECT_EQ(bus[3].count(), 0);
+    bus(3, 2);
+}
+
+TEST_F(FastSignalTest, test_event_bus_subscribe_during_emission)
+{
+    struct Subscriber {
+        EventBus<void(int)> *bus;
+        int calls = 0;
+
+        // Subscribing to new ids grows the table while the signal of event 0 is emitted
+        void on_event(int value) {
+            for (size_t id = 1; id <= 256; ++id)
+                bus->add(id, set_global_value1);
+            ++calls;
+            (*bus)(256, value);
+        }
+        void count(int) { ++calls; }
+    };
+
+    EventBus<void(int)> bus(1);
+    Subscriber subscriber{&bus};
+    bus.add<&Subscriber::on_event>(0, &subscriber);
+    bus.add<&Subscriber::count>(0, &subscriber);
+
+    bus(0, 7);
+    EXPECT_EQ(subscriber.calls, 2);
+    EXPECT_EQ(global_value1, 7);
+    EXPECT_EQ(bus.size(), 257);
+    EXPECT_EQ(bus[256].count(), 1);
+}
+
+TEST_F(FastSignalTest, test_typed_event_bus)
+{
+    struct Resized { int width; };
+    struct Closed {};
+
+    struct Window {
+        int width = 0;
+        int closed = 0;
+        void on_resized(const Resized &event) { width = event.width; }
+        void on_closed(const Closed&) { ++closed; }
+    };
+
+    TypedEventBus<Resized, Closed> bus;
+    Window window;
+    bus.add<Resized, &Window::on_resized>(&window);
+    auto con = bus.add<Closed, &Window::on_closed>(&window);
+
+    bus(Resized{640});
+    EXPECT_EQ(window.width, 640);
+    EXPECT_EQ(window.closed, 0);
+
+    bus(Closed{});
+    EXPECT_EQ(window.closed, 1);
+    EXPECT_EQ(bus.get<Closed>().count(), 1);
+
+    con.disconnect();
+    bus(Closed{});
+    EXPECT_EQ(window.closed, 1);
+}
+
+TEST_F(FastSignalTest, test_coalescing_signal)
+{
+    CoalescingSignal<void(int)> sig;
+    Observer observer;
+    sig.add<&Observer::set_value>(&observer);
+    sig.add(set_global_value1);
+    EXPECT_EQ(sig.count(), 2);
+
+    // Nothing is emitted until flush
+    EXPECT_CALL(observer, set_value(testing::_)).Times(0);
+    sig(1);
+    sig(2);
+    sig(3);
+    EXPECT_TRUE(sig.is_pending());
+    EXPECT_EQ(global_value1, 0);
+    testing::Mock::VerifyAndClearExpectations(&observer);
+
+    // Only the latest arguments are emitted, once
+    EXPECT_CALL(observer, set_value(3)).Times(1);
+    sig.flush();
+    EXPECT_FALSE(sig.is_pending());
+    EXPECT_EQ(global_value1, 3);
+
+    // Nothing pending, nothing emitted
+    sig.flush();
+}
+
+TEST_F(FastSignalTest, test_coalescing_group)
+{
+    CoalescingGroup group;
+    CoalescingSignal<void(int)> sig1(group);
+    CoalescingSignal<void(GlobalParam)> sig2(group);
+    CoalescingSignal<void(int)> sig3(group);
+    sig1.add(set_global_value1);
+    sig2.add(set_global_param1);
+    sig3.add(set_global_value2);
+
+    for (int i = 1; i <= 10; ++i) {
+        sig1(i);
+        sig2(GlobalParam(i * 10));
+    }
+    EXPECT_EQ(group.pending_count(), 2);
+
+    group.flush();
+    EXPECT_EQ(global_value1, 10);
+    EXPECT_EQ(global_param1.value, 100);
+    EXPECT_EQ(global_value2, 0);
+    EXPECT_EQ(group.pending_count(), 0);
+
+    // A signal flushed on its own leaves the group
+    sig3(5);
+    sig3.flush();
+    EXPECT_EQ(global_value2, 5);
+    EXPECT_EQ(group.pending_count(), 0);
+
+    // A pending signal destroyed before the flush leaves the group
+    {
+        CoalescingSignal<void(int)> sig4(group);
+        sig4.add(set_global_value2);
+        sig4(6);
+        EXPECT_EQ(group.pending_count(), 1);
+    }
+    EXPECT_EQ(group.pending_count(), 0);
+    group.flush();
+    EXPECT_EQ(global_value2, 5);
+}
+
+TEST_F(FastSignalTest, test_coalescing_group_reentrant)
+{
+    struct Forwarder {
+        CoalescingSignal<void(int)> *target;
+        void forward(int x) { (*target)(x + 1); }
+    };
+
+    CoalescingGroup group;
+    CoalescingSignal<void(int)> sig1(group);
+    CoalescingSignal<void(int)> sig2(group);
+    Forwarder forwarder{&sig2};
+    sig1.add<&Forwarder::forward>(&forwarder);
+    sig2.add(set_global_value1);
+
+    // sig2 becomes pending while sig1 is flushed, it's emitted on the next flush
+    sig1(1);
+    group.flush();
+    EXPECT_EQ(global_value1, 0);
+    EXPECT_EQ(group.pending_count(), 1);
+    group.flush();
+    EXPECT_EQ(global_value1, 2);
+    EXPECT_EQ(group.pending_count(), 0);
+
+    // Same when sig2 was already flushed in this pass
+    sig2(10);
+    sig1(20);
+    group.flush();
+    EXPECT_EQ(global_value1, 10);
+    EXPECT_EQ(group.pending_count(), 1);
+    group.flush();
+    EXPECT_EQ(global_value1, 21);
+}
+
+TEST_F(FastSignalTest, test_signal_filtered)
+{
+    FastSignal<void(int)> sig;
+    Observer observer1, observer2, observer3;
+    sig.add_filtered<&Observer::set_value>(1, &observer1);
+    auto con2 = sig.add_filtered<&Observer::set_value>(2, &observer2);
+    sig.add_filtered<&Observer::set_value>(2, &observer3);
+    sig.add_filtered(3, set_global_value1);
+    sig.add(set_global_value2);
+    EXPECT_EQ(sig.count(), 5);
+
+    EXPECT_CALL(observer1, set_value(1));
+    EXPECT_CALL(observer2, set_value(testing::_)).Times(0);
+    EXPECT_CALL(observer3, set_value(testing::_)).Times(0);
+    sig(1);
+    EXPECT_EQ(global_value1, 0);
+    EXPECT_EQ(global_value2, 1);
+    testing::Mock::VerifyAndClearExpectations(&observer1);
+
+    EXPECT_CALL(observer1, set_value(testing::_)).Times(0);
+    EXPECT_CALL(observer2, set_value(2));
+    EXPECT_CALL(observer3, set_value(2));
+    sig(2);
+    testing::Mock::VerifyAndClearExpectations(&observer2);
+    testing::Mock::VerifyAndClearExpectations(&observer3);
+
+    sig(3);
+    EXPECT_EQ(global_value1, 3);
+    EXPECT_EQ(global_value2, 3);
+
+    // No slot filtered on 4, only the unfiltered ones are called
+    sig(4);
+    EXPECT_EQ(global_value1, 3);
+    EXPECT_EQ(global_value2, 4);
+
+    con2.disconnect();
+    EXPECT_EQ(sig.count(), 4);
+    EXPECT_CALL(observer2, set_value(testing::_)).Times(0);
+    EXPECT_CALL(observer3, set_value(2)).Times(2);
+    sig(2);
+    sig(2);
+}
+
+TEST_F(FastSignalTest, test_signal_filtered_lifetime)
+{
+    FastSignal<void(int)> sig;
+    {
+        DisconnectableObserver observer;
+        auto con = sig.add_filtered<&DisconnectableObserver::set_value>(7, &observer);
+
+        con.block();
+        EXPECT_CALL(observer, set_value(7)).Times(0);
+        sig(7);
+        testing::Mock::VerifyAndClearExpectations(&observer);
+
+        con.unblock();
+        EXPECT_CALL(observer, set_value(7));
+        sig(7);
+    }
+    EXPECT_EQ(sig.count(), 0);
+    sig(7);
+
+    // Filtered slots move with the signal and are not copied
+    sig.add_filtered(8, set_global_value1);
+    FastSignal<void(int)> sig2(std::move(sig));
+    FastSignal<void(int)> sig3(sig2);
+    EXPECT_EQ(sig2.count(), 1);
+    EXPECT_EQ(sig3.count(), 0);
+
+    sig3(8);
+    EXPECT_EQ(global_value1, 0);
+    sig2(8);
+    EXPECT_EQ(global_value1, 8);
+}
+
+TEST_F(FastSignalTest, test_signal_filtered_adds_keys)
+{
+    struct Subscriber {
+        FastSignal<void(int)> *sig;
+        EventLoop *loops;
+        int calls = 0;
+        void on_value(int) {
+            ++calls;
+            // New keys and loops while the list of this slot's key (loop) is walked
+            for (int key = 0; key < 16; ++key)
+                sig->add_filtered<&Subscriber::on_other>(100 * calls + key, this);
+            for (int i = 0; i < 4; ++i)
+                sig->add_on<&Subscriber::on_other>(loops[i], this);
+        }
+        void on_other(int) {}
+    };
+
+    FastSignal<void(int)> sig;
+    EventLoop loops[8];
+    Subscriber filtered{&sig, loops};
+    Subscriber looped{&sig, loops + 4};
+
+    // A dead slot in front, the emission walks the list with the liveness bitmap
+    sig.add_filtered(1, set_global_value1).disconnect();
+    sig.add_filtered<&Subscriber::on_value>(1, &filtered);
+    sig.add_filtered(1, set_global_value2);
+    sig(1);
+    EXPECT_EQ(filtered.calls, 1);
+    EXPECT_EQ(global_value1, 0);
+    EXPECT_EQ(global_value2, 1);
+
+    EventLoop own_loop;
+    sig.add_on<&Subscriber::on_value>(own_loop, &looped);
+    sig.add_on(own_loop, set_global_value1);
+    sig(2);
+    EXPECT_EQ(looped.calls, 1);
+    EXPECT_EQ(global_value1, 2);
+}
+
+TEST_F(FastSignalTest, test_signal_filtered_rvalue_key)
+{
+    static std::vector<std::string> received;
+    received.clear();
+    auto receive = +[](std::string value) { received.push_back(std::move(value)); };
+
+    // The slots take the argument by value, the first one may not move it away from the others
+    FastSignal<void(std::string)> sig;
+    sig.add(receive);
+    sig.add(receive);
+    sig.add_filtered("key", receive);
+    sig(std::string("key"));
+    EXPECT_EQ(received, std::vector<std::string>({"key", "key", "key"}));
+}
+
+TEST_F(FastSignalTest, test_signal_forward)
+{
+    FastSignal<void(int)> sig1, sig2, sig3;
+    sig2.add(set_global_value1);
+    sig3.add(set_global_value2);
+
+    EXPECT_TRUE(sig1.forward_to(sig2));
+    EXPECT_TRUE(sig2.forward_to(sig3));
+
+    sig1(1);
+    EXPECT_EQ(global_value1, 1);
+    EXPECT_EQ(global_value2, 1);
+
+    // Already forwarded, directly or through another signal
+    EXPECT_FALSE(sig1.forward_to(sig2));
+    EXPECT_FALSE(sig1.forward_to(sig3));
+    // Cycles and self forwarding are refused
+    EXPECT_FALSE(sig3.forward_to(sig1));
+    EXPECT_FALSE(sig1.forward_to(sig1));
+
+    // A blocked signal doesn't forward either
+    sig2.block();
+    sig1(2);
+    EXPECT_EQ(global_value1, 1);
+    EXPECT_EQ(global_value2, 1);
+    sig2.unblock();
+
+    sig2.stop_forwarding(sig3);
+    sig1(3);
+    EXPECT_EQ(global_value1, 3);
+    EXPECT_EQ(global_value2, 1);
+
+    // Emitting the target doesn't go back to the source
+    global_value1 = 0;
+    sig1.add(set_global_value2);
+    sig2(4);
+    EXPECT_EQ(global_value1, 4);
+    EXPECT_EQ(global_value2, 1);
+}
+
+TEST_F(FastSignalTest, test_signal_forward_rvalue)
+{
+    static std::vector<std::string> received;
+    received.clear();
+    auto receive = +[](std::string value) { received.push_back(std::move(value)); };
+
+    // The source's slots take the argument by value, the one-shot slots and the target still get it
+    FastSignal<void(std::string)> source, target;
+    source.add(receive);
+    source.add_once(receive);
+    target.add(receive);
+    source.forward_to(target);
+    source(std::string("hello"));
+    EXPECT_EQ(received, std::vector<std::string>({"hello", "hello", "hello"}));
+
+    // Assigning a signal to itself keeps its links
+    auto &alias = source;
+    source = std::move(alias);
+    received.clear();
+    source(std::string("again"));
+    EXPECT_EQ(received, std::vector<std::string>({"again", "again"}));
+}
+
+TEST_F(FastSignalTest, test_signal_forward_lifetime)
+{
+    FastSignal<void(int)> sig1;
+    {
+        // Target destroyed before the source
+        FastSignal<void(int)> sig2;
+        sig2.add(set_global_value1);
+        sig1.forward_to(sig2);
+        sig1(1);
+        EXPECT_EQ(global_value1, 1);
+    }
+    sig1(2);
+    EXPECT_EQ(global_value1, 1);
+
+    FastSignal<void(int)> sig3;
+    sig3.add(set_global_value2);
+    {
+        // Source destroyed before the target
+        FastSignal<void(int)> sig4;
+        sig4.forward_to(sig3);
+        sig4(3);
+        EXPECT_EQ(global_value2, 3);
+    }
+    sig3(4);
+    EXPECT_EQ(global_value2, 4);
+
+    // Both ends can be moved
+    FastSignal<void(int)> source, target;
+    target.add(set_global_value1);
+    source.forward_to(target);
+
+    FastSignal<void(int)> moved_source(std::move(source));
+    FastSignal<void(int)> moved_target;
+    moved_target = std::move(target);
+
+    moved_source(5);
+    EXPECT_EQ(global_value1, 5);
+
+    source(6);
+    target(6);
+    EXPECT_EQ(global_value1, 5);
+
+    // Copies don't forward
+    FastSignal<void(int)> copy(moved_source);
+    copy(7);
+    EXPECT_EQ(global_value1, 5);
+
+    std::vector<FastSignal<void(int)>> chain(2);
+    chain[0].forward_to(chain[1]);
+    chain[1].add(set_global_value2);
+    chain.resize(100);
+    chain[0](8);
+    EXPECT_EQ(global_value2, 8);
+}
+
+TEST_F(FastSignalTest, test_signal_once)
+{
+    FastSignal<void(int)> sig;
+    Observer observer;
+    sig.add_once<&Observer::set_value>(&observer);
+    sig.add_once(set_global_value1);
+    sig.add(set_global_value2);
+    EXPECT_EQ(sig.count(), 3);
+
+    EXPECT_CALL(observer, set_value(1)).Times(1);
+    sig(1);
+    EXPECT_EQ(global_value1, 1);
+    EXPECT_EQ(global_value2, 1);
+    EXPECT_EQ(sig.count(), 1);
+
+    // One-shot slots are gone, the main list was never dirtied
+    sig(2);
+    EXPECT_EQ(global_value1, 1);
+    EXPECT_EQ(global_value2, 2);
+    EXPECT_EQ(sig.actual_count(), 1);
+
+    // Disconnected before being called
+    auto con = sig.add_once(set_global_value1);
+    EXPECT_EQ(sig.count(), 2);
+    con.disconnect();
+    EXPECT_EQ(sig.count(), 1);
+    sig(3);
+    EXPECT_EQ(global_value1, 1);
+
+    // Blocked one-shot slots wait until they are unblocked
+    con = sig.add_once(set_global_value1);
+    con.block();
+    sig(4);
+    EXPECT_EQ(global_value1, 1);
+    con.unblock();
+    sig(5);
+    EXPECT_EQ(global_value1, 5);
+    EXPECT_EQ(sig.count(), 1);
+
+    // Disconnecting after the call is a no-op
+    con.disconnect();
+    EXPECT_EQ(sig.count(), 1);
+}
+
+TEST_F(FastSignalTest, test_signal_once_reentrant)
+{
+    struct Rearm {
+        FastSignal<void(int)> *sig;
+        int calls = 0;
+        void on_value(int x) {
+            ++calls;
+            // Added during the emission, called on the next one
+            sig->add_once<&Rearm::on_value>(this);
+            // Emitting again doesn't call the one-shot slots twice
+            if (x > 0)
+                (*sig)(x - 1);
+        }
+    };
+
+    FastSignal<void(int)> sig;
+    Rearm rearm{&sig};
+    sig.add_once<&Rearm::on_value>(&rearm);
+
+    sig(1);
+    EXPECT_EQ(rearm.calls, 1);
+    EXPECT_EQ(sig.count(), 1);
+
+    sig(0);
+    EXPECT_EQ(rearm.calls, 2);
+    EXPECT_EQ(sig.count(), 1);
+}
+
+TEST_F(FastSignalTest, test_signal_once_adds_lists)
+{
+    struct Subscriber {
+        FastSignal<void(int)> *sig;
+        EventLoop *loop;
+        int id;
+        int calls = 0;
+        void on_value(int) {
+            ++calls;
+            // New keys and loops add slot lists while the one-shot list is walked
+            for (int key = 0; key < 16; ++key)
+                sig->add_filtered<&Subscriber::on_filtered>(id * 16 + key, this);
+            sig->add_on<&Subscriber::on_filtered>(*loop, this);
+        }
+        void on_filtered(int) {}
+    };
+
+    FastSignal<void(int)> sig;
+    EventLoop loops[4];
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for (int i = 0; i < 4; ++i) {
+        subscribers.push_back(std::make_unique<Subscriber>(Subscriber{&sig, &loops[i], i + 1}));
+        sig.add_once<&Subscriber::on_value>(subscribers.back().get());
+    }
+
+    sig(0);
+    for (auto &subscriber : subscribers)
+        EXPECT_EQ(subscriber->calls, 1);
+    // 16 filtered slots and one loop slot per subscriber
+    EXPECT_EQ(sig.count(), 4u * 17);
+}
+
+TEST_F(FastSignalTest, test_signal_once_disconnectable)
+{
+    FastSignal<void(int)> sig;
+    {
+        DisconnectableObserver observer;
+        sig.add_once<&DisconnectableObserver::set_value>(&observer);
+        sig.add_once<&DisconnectableObserver::set_value>(&observer);
+        EXPECT_CALL(observer, set_value(1)).Times(2);
+        sig(1);
+        EXPECT_EQ(sig.count(), 0);
+
+        sig.add_once<&DisconnectableObserver::set_value>(&observer);
+    }
+    // Destroyed before being called
+    EXPECT_EQ(sig.count(), 0);
+    sig(2);
+}
+
+TEST_F(FastSignalTest, test_signal_move_container)
+{
+    struct Widget {
+        FastSignal<void(int)> changed;
+    };
+
+    struct WidgetObserver : public Disconnectable {
+        int value = 0;
+        void set_value(int x) { value = x; }
+    };
+
+    std::vector<Widget> widgets;
+    std::vector<ConnectionView> connections;
+    for (int i = 0; i < 8; ++i) {
+        // Each push_back may reallocate and move all the signals
+        widgets.emplace_back();
+        connections.push_back(widgets.back().changed.add(set_global_value1));
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        widgets[i].changed(i + 1);
+        EXPECT_EQ(global_value1, i + 1);
+    }
+
+    // Connections still reach their signal after the moves
+    connections[3].disconnect();
+    EXPECT_EQ(widgets[3].changed.count(), 0);
+    EXPECT_EQ(widgets[4].changed.count(), 1);
+
+    // Swapping exchanges the slots, the connections follow them
+    std::swap(widgets[0].changed, widgets[3].changed);
+    EXPECT_EQ(widgets[0].changed.count(), 0);
+    EXPECT_EQ(widgets[3].changed.count(), 1);
+    connections[0].disconnect();
+    EXPECT_EQ(widgets[3].changed.count(), 0);
+
+    // Move assignment disconnects the slots of the target
+    widgets[1].changed = std::move(widgets[2].changed);
+    EXPECT_EQ(widgets[1].changed.count(), 1);
+    connections[1].disconnect();
+    EXPECT_EQ(widgets[1].changed.count(), 1);
+    connections[2].disconnect();
+    EXPECT_EQ(widgets[1].changed.count(), 0);
+
+    // A disconnectable slot of a moved signal is removed on its destruction
+    WidgetObserver *observer = new WidgetObserver();
+    widgets[5].changed.add<&WidgetObserver::set_value>(observer);
+    FastSignal<void(int)> moved(std::move(widgets[5].changed));
+    EXPECT_EQ(moved.count(), 2);
+    delete observer;
+    EXPECT_EQ(moved.count(), 1);
+}
+
+TEST_F(FastSignalTest, test_signal_emit_moved_from)
+{
+    for (bool assign : {false, true}) {
+        FastSignal<void(int)> sig;
+        sig.add(set_global_value1).disconnect();
+        sig.add_filtered(1, set_global_value1).disconnect();
+        sig.add_once(set_global_value1).disconnect();
+
+        // The moved-from signal is empty and clean
+        FastSignal<void(int)> assigned;
+        std::optional<FastSignal<void(int)>> constructed;
+        if (assign)
+            assigned = std::move(sig);
+        else
+            constructed.emplace(std::move(sig));
+        FastSignal<void(int)> &moved = assign ? assigned : *constructed;
+        sig(1);
+        moved(1);
+        EXPECT_EQ(global_value1, 0);
+
+        sig.add_filtered(2, set_global_value2);
+        sig(2);
+        EXPECT_EQ(global_value2, 2);
+    }
+
+    // And unblocked
+    FastSignal<void(int)> blocked;
+    blocked.block();
+    FastSignal<void(int)> moved(std::move(blocked));
+    EXPECT_TRUE(moved.is_blocked());
+    EXPECT_FALSE(blocked.is_blocked());
+}
+
+TEST_F(FastSignalTest, test_signal_devirtualized)
+{
+    struct Handler {
+        int value = 0;
+        virtual ~Handler() = default;
+        virtual void on_value(const int &x) { value = x; }
+        virtual void on_value_by_copy(int x) { value = x; }
+        void on_value_direct(const int &x) { value = -x; }
+    };
+
+    struct DoubleHandler : public Handler {
+        void on_value(const int &x) override { value = 2 * x; }
+        void on_value_by_copy(int x) override { value = 2 * x; }
+    };
+
+    // A second base moves Handler away from the start of the object
+    struct Padding {
+        virtual ~Padding() = default;
+        int padding[4] = {};
+    };
+
+    struct OffsetHandler : public Padding, public DoubleHandler {
+        void on_value(const int &x) override { value = 3 * x; }
+    };
+
+    FastSignal<void(const int&)> sig;
+    DoubleHandler double_handler;
+    OffsetHandler offset_handler;
+    Handler *handlers[] = {&double_handler, &offset_handler};
+
+    // Resolved through the base class pointer to the dynamic type's override
+    for (Handler *handler : handlers)
+        sig.add_devirtualized<&Handler::on_value>(handler);
+    sig(5);
+    EXPECT_EQ(double_handler.value, 10);
+    EXPECT_EQ(offset_handler.value, 15);
+
+    // Non-virtual member functions are called directly too
+    FastSignal<void(const int&)> direct_sig;
+    direct_sig.add_devirtualized<&Handler::on_value_direct>(&offset_handler);
+    direct_sig(5);
+    EXPECT_EQ(offset_handler.value, -5);
+
+    // Parameters taken by copy fall back to the thunk, still virtual
+    FastSignal<void(int)> copy_sig;
+    for (Handler *handler : handlers)
+        copy_sig.add_devirtualized<&Handler::on_value_by_copy>(handler);
+    copy_sig(7);
+    EXPECT_EQ(double_handler.value, 14);
+    EXPECT_EQ(offset_handler.value, 14);
+
+    // Devirtualized slots are disconnected and blocked like any other
+    ConnectionView conn = sig.add_devirtualized<&Handler::on_value>(&double_handler);
+    EXPECT_EQ(sig.count(), 3);
+    conn.block();
+    sig(1);
+    EXPECT_EQ(double_handler.value, 2);
+    conn.unblock();
+    conn.disconnect();
+    EXPECT_EQ(sig.count(), 2);
+
+    // Disconnectable objects keep the regular slot
+    struct DisconnectableHandler : public Disconnectable {
+        int value = 0;
+        virtual void on_value(const int &x) { value = x; }
+    };
+
+    {
+        DisconnectableHandler handler;
+        sig.add_devirtualized<&DisconnectableHandler::on_value>(&handler);
+        sig(4);
+        EXPECT_EQ(handler.value, 4);
+    }
+    EXPECT_EQ(sig.count(), 2);
+}
+
+TEST_F(FastSignalTest, test_signal_dead_slots)
+{
+    struct Counter {
+        int calls = 0;
+        void count(int) { ++calls; }
+    };
+
+    // Spans several words of the liveness bitmap
+    constexpr int SLOT_COUNT = 200;
+    std::vector<Counter> counters(SLOT_COUNT);
+    std::vector<ConnectionView> connections;
+    FastSignal<void(int)> sig;
+    for (auto &counter : counters)
+        connections.push_back(sig.add<&Counter::count>(&counter));
+
+    // Blocked slots stay in place, the emission skips them
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        if (i % 7 != 0)
+            connections[i].block();
+    }
+    sig(1);
+    for (int i = 0; i < SLOT_COUNT; ++i)
+        EXPECT_EQ(counters[i].calls, i % 7 == 0 ? 1 : 0);
+    EXPECT_EQ(sig.actual_count(), SLOT_COUNT);
+
+    // Disconnected slots are removed, the blocked ones keep their slot until unblocked
+    for (int i = 0; i < SLOT_COUNT; i += 2)
+        connections[i].disconnect();
+    sig(1);
+    EXPECT_EQ(sig.count(), SLOT_COUNT / 2);
+    EXPECT_EQ(sig.actual_count(), SLOT_COUNT / 2);
+
+    for (int i = 1; i < SLOT_COUNT; i += 2)
+        connections[i].unblock();
+    for (auto &counter : counters)
+        counter.calls = 0;
+    sig(1);
+    for (int i = 0; i < SLOT_COUNT; ++i)
+        EXPECT_EQ(counters[i].calls, i % 2);
+
+    // Slots added after the compaction are live
+    Counter added;
+    sig.add<&Counter::count>(&added);
+    connections[1].block();
+    sig(1);
+    EXPECT_EQ(added.calls, 1);
+    EXPECT_EQ(counters[1].calls, 1);
+    EXPECT_EQ(counters[3].calls, 2);
+
+    // A slot disconnected by an earlier slot of the same emission isn't called
+    struct Disconnector {
+        ConnectionView connection;
+        void disconnect(int) { connection.disconnect(); }
+    };
+
+    FastSignal<void(int)> sig2;
+    Counter first, second;
+    Disconnector disconnector;
+    ConnectionView blocked = sig2.add<&Counter::count>(&first);
+    blocked.block();
+    sig2.add<&Disconnector::disconnect>(&disconnector);
+    disconnector.connection = sig2.add<&Counter::count>(&second);
+    sig2(1);
+    EXPECT_EQ(first.calls, 0);
+    EXPECT_EQ(second.calls, 0);
+    EXPECT_EQ(sig2.count(), 2);
+}
+
+TEST_F(FastSignalTest, test_signal_emit_prefetched)
+{
+    struct Counter {
+        int calls = 0;
+        void count(int) { ++calls; }
+    };
+
+    std::vector<std::unique_ptr<Counter>> counters;
+    std::vector<ConnectionView> connections;
+    FastSignal<void(int)> sig;
+    for (int i = 0; i < 20; ++i) {
+        counters.push_back(std::make_unique<Counter>());
+        connections.push_back(sig.add<&Counter::count>(counters.back().get()));
+    }
+    sig.add(set_global_value1);
+
+    // Prefetching past the end of the slots is harmless
+    sig.emit_prefetched<4>(1);
+    sig.emit_prefetched<64>(2);
+    for (auto &counter : counters)
+        EXPECT_EQ(counter->calls, 2);
+    EXPECT_EQ(global_value1, 2);
+
+    connections[3].disconnect();
+    connections[5].block();
+    sig.emit_prefetched(3);
+    EXPECT_EQ(counters[3]->calls, 2);
+    EXPECT_EQ(counters[5]->calls, 2);
+    EXPECT_EQ(counters[4]->calls, 3);
+    EXPECT_EQ(sig.actual_count(), 20);
+
+    sig.block();
+    sig.emit_prefetched(4);
+    EXPECT_EQ(global_value1, 3);
+}
+
+TEST_F(FastSignalTest, test_signal_group)
+{
+    struct Param {
+        int value = 0;
+    };
+
+    struct GroupObserver {
+        std::vector<int> calls;
+        void on_event() { calls.push_back(0); }
+        void on_value(int x) { calls.push_back(x); }
+        void on_param(Param &param) { calls.push_back(100); ++param.value; }
+    };
+
+    SignalGroup<void(), void(int), void(Param&)> group;
+    GroupObserver observer1, observer2;
+    group.add<&GroupObserver::on_event, &GroupObserver::on_value, &GroupObserver::on_param>(&observer1);
+    ConnectionView conn = group.add<&GroupObserver::on_event, &GroupObserver::on_value, &GroupObserver::on_param>(&observer2);
+    EXPECT_EQ(group.count(), 2);
+
+    // All the handlers of an observer are called before the next observer
+    Param param;
+    group(std::tuple<>(), std::tuple<int>(5), std::tie(param));
+    EXPECT_EQ(observer1.calls, std::vector<int>({0, 5, 100}));
+    EXPECT_EQ(observer2.calls, std::vector<int>({0, 5, 100}));
+    EXPECT_EQ(param.value, 2);
+
+    // A single signal of the group
+    group.emit<1>(7);
+    EXPECT_EQ(observer1.calls.back(), 7);
+    EXPECT_EQ(observer2.calls.back(), 7);
+    group.emit<2>(param);
+    EXPECT_EQ(param.value, 4);
+
+    conn.block();
+    group.emit<0>();
+    EXPECT_EQ(observer1.calls.size(), 6u);
+    EXPECT_EQ(observer2.calls.size(), 5u);
+    conn.unblock();
+
+    conn.disconnect();
+    group(std::tuple<>(), std::tuple<int>(1), std::tie(param));
+    EXPECT_EQ(group.count(), 1);
+    EXPECT_EQ(observer2.calls.size(), 5u);
+    EXPECT_EQ(param.value, 5);
+
+    // Disconnectable observers leave the group on destruction
+    struct DisconnectableObserver : public Disconnectable {
+        int calls = 0;
+        void on_event() { ++calls; }
+        void on_value(int) { ++calls; }
+        void on_param(Param&) { ++calls; }
+    };
+
+    {
+        DisconnectableObserver observer;
+        group.add<&DisconnectableObserver::on_event, &DisconnectableObserver::on_value,
+            &DisconnectableObserver::on_param>(&observer);
+        group(std::tuple<>(), std::tuple<int>(1), std::tie(param));
+        EXPECT_EQ(observer.calls, 3);
+        EXPECT_EQ(group.count(), 2);
+    }
+    EXPECT_EQ(group.count(), 1);
+}
+
+TEST_F(FastSignalTest, test_signal_group_add_during_emission)
+{
+    struct Member {
+        int calls = 0;
+        void on_event() { ++calls; }
+        void on_value(int) { ++calls; }
+    };
+
+    // Adds members to the group it is called from
+    struct Recruiter {
+        SignalGroup<void(), void(int)> *group;
+        std::vector<std::unique_ptr<Member>> members;
+        void recruit() {
+            for (int i = 0; i < 64; ++i) {
+                members.push_back(std::make_unique<Member>());
+                group->add<&Member::on_event, &Member::on_value>(members.back().get());
+            }
+        }
+        void on_event() {}
+        void on_value(int) { recruit(); }
+    };
+
+    SignalGroup<void(), void(int)> group;
+    Recruiter recruiter{&group, {}};
+    Member member;
+    group.add<&Recruiter::on_event, &Recruiter::on_value>(&recruiter);
+    group.add<&Member::on_event, &Member::on_value>(&member);
+
+    // The members added by the emission are called by the next one
+    group(std::tuple<>(), std::tuple<int>(1));
+    EXPECT_EQ(member.calls, 2);
+    EXPECT_EQ(recruiter.members[0]->calls, 0);
+    EXPECT_EQ(group.count(), 2 + 64);
+
+    group.emit<1>(2);
+    EXPECT_EQ(member.calls, 3);
+    EXPECT_EQ(recruiter.members[0]->calls, 1);
+    EXPECT_EQ(group.count(), 2 + 128);
+}
+
+TEST_F(FastSignalTest, test_signal_event_loop)
+{
+    struct Listener {
+        std::vector<int> values;
+        std::thread::id thread;
+        void on_value(int x) { values.push_back(x); thread = std::this_thread::get_id(); }
+    };
+
+    FastSignal<void(int)> sig;
+
+    // Same thread, called inline
+    EventLoop local_loop;
+    Listener local;
+    sig.add_on<&Listener::on_value>(local_loop, &local);
+    sig(1);
+    EXPECT_EQ(local.values, std::vector<int>({1}));
+    EXPECT_EQ(local_loop.wakeups(), 0u);
+
+    // A loop owned by another thread gets one task and one wakeup per emission, for all its slots
+    EventLoop remote_loop;
+    std::thread([&remote_loop]() { remote_loop.attach(); }).join();
+
+    Listener remote1, remote2, remote3;
+    sig.add_on<&Listener::on_value>(remote_loop, &remote1);
+    sig.add_on<&Listener::on_value>(remote_loop, &remote2);
+    ConnectionView conn = sig.add_on<&Listener::on_value>(remote_loop, &remote3);
+    sig(2);
+    EXPECT_TRUE(remote1.values.empty());
+    EXPECT_EQ(remote_loop.wakeups(), 1u);
+
+    // Already pending, no new wakeup
+    sig(3);
+    EXPECT_EQ(remote_loop.wakeups(), 1u);
+
+    // Disconnected slots are skipped even if the emission happened before
+    conn.disconnect();
+    EXPECT_EQ(remote_loop.process_events(), 2u);
+    EXPECT_EQ(remote1.values, std::vector<int>({2, 3}));
+    EXPECT_EQ(remote2.values, std::vector<int>({2, 3}));
+    EXPECT_TRUE(remote3.values.empty());
+    EXPECT_EQ(local.values, std::vector<int>({1, 2, 3}));
+
+    // Pending deliveries of a destroyed loop are dropped
+    {
+        EventLoop dropped_loop;
+        std::thread([&dropped_loop]() { dropped_loop.attach(); }).join();
+        FastSignal<void(int)> sig2;
+        Listener listener;
+        sig2.add_on<&Listener::on_value>(dropped_loop, &listener);
+        sig2(4);
+    }
+}
+
+TEST_F(FastSignalTest, test_signal_event_loop_thread)
+{
+    struct Listener {
+        std::atomic<int> sum{0};
+        std::thread::id thread;
+        void on_value(const int &x) { sum += x; thread = std::this_thread::get_id(); }
+    };
+
+    EventLoop loop;
+    std::thread::id loop_thread;
+    std::thread thread([&loop, &loop_thread]() {
+        loop_thread = std::this_thread::get_id();
+        loop.run();
+    });
+    // The loop belongs to its thread once run() started
+    while (loop.is_current())
+        std::this_thread::yield();
+
+    FastSignal<void(const int&)> sig;
+    Listener listener;
+    sig.add_on<&Listener::on_value>(loop, &listener);
+    for (int i = 1; i <= 100; ++i)
+        sig(i);
+
+    loop.stop();
+    thread.join();
+
+    EXPECT_EQ(listener.sum, 5050);
+    EXPECT_EQ(listener.thread, loop_thread);
+    EXPECT_LE(loop.wakeups(), 100u);
+}
+
+TEST_F(FastSignalTest, test_spsc_signal)
+{
+    struct Message {
+        int id = 0;
+        std::string text;
+    };
+
+    struct Consumer {
+        std::vector<int> ids;
+        std::string text;
+        void on_message(Message &message, int extra) {
+            ids.push_back(message.id + extra);
+            text += message.text;
+            message.text.clear();
+        }
+    };
+
+    SpscSignal<void(Message&, int), 4> sig;
+    Consumer consumer;
+    sig.add<&Consumer::on_message>(&consumer);
+
+    // The arguments are copied into the ring
+    Message message{1, "a"};
+    EXPECT_TRUE(sig.try_emit(message, 0));
+    message.text = "b";
+    EXPECT_TRUE(sig.try_emit(message, 10));
+    EXPECT_TRUE(sig.try_emit(Message{3, "c"}, 0));
+    EXPECT_TRUE(sig.try_emit(message, 100));
+    EXPECT_FALSE(sig.try_emit(message, 0));
+    EXPECT_TRUE(consumer.ids.empty());
+    EXPECT_EQ(message.text, "b");
+
+    EXPECT_EQ(sig.process(2), 2u);
+    EXPECT_EQ(consumer.ids, std::vector<int>({1, 11}));
+    EXPECT_TRUE(sig.try_emit(message, 0));
+    EXPECT_EQ(sig.process(), 3u);
+    EXPECT_EQ(consumer.ids, std::vector<int>({1, 11, 3, 101, 1}));
+    EXPECT_EQ(consumer.text, "abcbb");
+    EXPECT_EQ(sig.process(), 0u);
+
+    // Pending emissions are destroyed with the signal
+    auto tracked = std::make_shared<int>(0);
+    {
+        SpscSignal<void(std::shared_ptr<int>)> pending;
+        pending(tracked);
+        pending(tracked);
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST_F(FastSignalTest, test_spsc_signal_thread)
+{
+    struct Consumer {
+        int64_t sum = 0;
+        int last = 0;
+        bool ordered = true;
+        void on_value(int x) {
+            ordered = ordered && x == last + 1;
+            last = x;
+            sum += x;
+        }
+    };
+
+    constexpr int COUNT = 100000;
+    SpscSignal<void(int), 64> sig;
+    Consumer consumer;
+    sig.add<&Consumer::on_value>(&consumer);
+
+    std::thread producer([&sig]() {
+        for (int i = 1; i <= COUNT; ++i)
+            sig(i);
+    });
+
+    while (consumer.last != COUNT) {
+        if (!sig.process())
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(consumer.ordered);
+    EXPECT_EQ(consumer.sum, int64_t(COUNT) * (COUNT + 1) / 2);
+}
+
+TEST_F(FastSignalTest, test_sharded_signal)
+{
+    struct Listener {
+        int sum = 0;
+        ShardedConnection connection;
+        void on_value(int x) { sum += x; }
+        void on_value_once(int x) {
+            sum += x;
+            connection.disconnect();
+        }
+    };
+
+    ShardedSignal<void(int)> sig(4);
+    EXPECT_EQ(sig.shard_count(), 4u);
+
+    Listener listeners[3];
+    auto first = sig.add<&Listener::on_value>(&listeners[0]);
+    listeners[1].connection = sig.add<&Listener::on_value_once>(&listeners[1]);
+
+    // Slots connected from other threads land in other shards
+    std::thread other([&]() {
+        listeners[2].connection = sig.add<&Listener::on_value>(&listeners[2]);
+    });
+    other.join();
+    EXPECT_EQ(sig.count(), 3u);
+
+    sig(1);
+    sig(10);
+    EXPECT_EQ(listeners[0].sum, 11);
+    // Disconnected itself from inside the emission
+    EXPECT_EQ(listeners[1].sum, 1);
+    EXPECT_EQ(listeners[2].sum, 11);
+
+    // Disconnected from another thread than the one that connected
+    std::thread disconnecting([&]() { first.disconnect(); });
+    disconnecting.join();
+    first.disconnect();
+    sig(100);
+    EXPECT_EQ(listeners[0].sum, 11);
+    EXPECT_EQ(listeners[2].sum, 111);
+    EXPECT_EQ(sig.count(), 1u);
+
+    // The connection can outlive the signal
+    ShardedConnection survivor;
+    {
+        ShardedSignal<void(int)> temporary(2);
+        survivor = temporary.add<&Listener::on_value>(&listeners[0]);
+    }
+    survivor.disconnect();
+    EXPECT_EQ(ShardedSignal<void(int)>(0).shard_count(), 1u);
+}
+
+TEST_F(FastSignalTest, test_signal_connect_during_emission)
+{
+    struct Spawner {
+        FastSignal<void()> *sig;
+        int calls = 0;
+        int spawned_calls = 0;
+        void spawn() {
+            ++calls;
+            // Reallocates the slot array under the emission
+            for (int i = 0; i < 16; ++i)
+                sig->add<&Spawner::spawned>(this);
+        }
+        void spawned() { ++spawned_calls; }
+    };
+
+    FastSignal<void()> sig;
+    Spawner spawner{&sig};
+    sig.add<&Spawner::spawn>(&spawner);
+
+    // The new slots are for the next emission
+    sig();
+    EXPECT_EQ(spawner.calls, 1);
+    EXPECT_EQ(spawner.spawned_calls, 0);
+    EXPECT_EQ(sig.count(), 17u);
+
+    sig.emit_prefetched();
+    EXPECT_EQ(spawner.calls, 2);
+    EXPECT_EQ(spawner.spawned_calls, 16);
+
+    // A blocked slot, the emission walks the liveness bitmap
+    sig.add(+[]() {}).block();
+    sig();
+    EXPECT_EQ(spawner.calls, 3);
+    EXPECT_EQ(spawner.spawned_calls, 48);
+    EXPECT_EQ(sig.count(), 50u);
+}
+
+TEST_F(FastSignalTest, test_sharded_signal_connect_during_emission)
+{
+    struct Spawner {
+        ShardedSignal<void()> *sig;
+        int calls = 0;
+        int spawned_calls = 0;
+        void spawn() {
+            ++calls;
+            for (int i = 0; i < 16; ++i)
+                sig->add<&Spawner::spawned>(this);
+        }
+        void spawned() { ++spawned_calls; }
+    };
+
+    // A single shard, the slots connect to the shard being emitted
+    ShardedSignal<void()> sig(1);
+    Spawner spawner{&sig};
+    sig.add<&Spawner::spawn>(&spawner);
+
+    sig();
+    EXPECT_EQ(spawner.calls, 1);
+    EXPECT_EQ(spawner.spawned_calls, 0);
+    sig();
+    EXPECT_EQ(spawner.calls, 2);
+    EXPECT_EQ(spawner.spawned_calls, 16);
+    EXPECT_EQ(sig.count(), 33u);
+}
+
+TEST_F(FastSignalTest, test_sharded_signal_threads)
+{
+    struct Listener {
+        std::atomic<int> calls{0};
+        void on_value(int) { calls.fetch_add(1, std::memory_order_relaxed); }
+    };
+
+    constexpr int THREADS = 4;
+    constexpr int ROUNDS = 2000;
+    ShardedSignal<void(int)> sig(THREADS);
+
+    // Always connected, gets every emission
+    Listener permanent;
+    sig.add<&Listener::on_value>(&permanent);
+
+    std::atomic<bool> done{false};
+    std::thread emitter([&]() {
+        while (!done.load(std::memory_order_relaxed))
+            sig(0);
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&sig]() {
+            Listener listener;
+            for (int i = 0; i < ROUNDS; ++i) {
+                ShardedConnection connection = sig.add<&Listener::on_value>(&listener);
+                connection.disconnect();
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    done = true;
+    emitter.join();
+
+    EXPECT_EQ(sig.count(), 1u);
+    int calls = permanent.calls.load();
+    sig(0);
+    EXPECT_EQ(permanent.calls.load(), calls + 1);
+}
+
+TEST_F(FastSignalTest, test_signal_memory_usage)
+{
+    CountingResource resource;
+    {
+        FastSignal<void(int)> sig(&resource);
+        MemoryUsage usage = sig.memory_usage();
+        EXPECT_EQ(usage.slots, 0);
+        EXPECT_EQ(usage.heap_bytes, 0);
+
+        std::vector<ConnectionView> connections;
+        for (int i = 0; i < 10; ++i)
+            connections.push_back(sig.add(set_global_value1));
+        sig.add_filtered(3, set_global_value2);
+        connections[0].block();
+        connections[1].disconnect();
+        connections[2].disconnect();
+
+        usage = sig.memory_usage();
+        EXPECT_EQ(usage.slots, 9);
+        EXPECT_EQ(usage.tombstones, 2);
+        EXPECT_GE(usage.capacity, 11);
+        // Everything the signal allocated, connection records included
+        EXPECT_EQ(usage.heap_bytes, resource.bytes);
+
+        sig(1);
+        usage = sig.memory_usage();
+        EXPECT_EQ(usage.slots, 9);
+        EXPECT_EQ(usage.tombstones, 0);
+        EXPECT_EQ(usage.heap_bytes, resource.bytes);
+
+        sig.shrink_to_fit();
+        usage = sig.memory_usage();
+        EXPECT_EQ(usage.capacity, 9);
+        EXPECT_EQ(usage.heap_bytes, resource.bytes);
+
+        connections[3].disconnect();
+        sig.shrink_to_fit();
+        EXPECT_EQ(sig.memory_usage().capacity, 8);
+        EXPECT_EQ(sig.memory_usage().tombstones, 0);
+    }
+    EXPECT_EQ(resource.bytes, 0);
+
+    {
+        // The forwarding links are allocated in the extension of both signals
+        FastSignal<void(int)> source(&resource);
+        FastSignal<void(int)> target(&resource);
+        EXPECT_EQ(source.memory_usage().heap_bytes, 0);
+        source.forward_to(target);
+        EXPECT_EQ(source.memory_usage().heap_bytes + target.memory_usage().heap_bytes, resource.bytes);
+
+        FastSignal<void(int)> moved(std::move(source));
+        EXPECT_EQ(source.memory_usage().heap_bytes, 0);
+        EXPECT_EQ(moved.memory_usage().heap_bytes + target.memory_usage().heap_bytes, resource.bytes);
+    }
+    EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(FastSignalTest, test_disconnectable_memory_usage)
+{
+    CountingResource resource;
+    {
+        DisconnectableObserver observer;
+        FastSignal<void(int)> sig1(&resource);
+        {
+            FastSignal<void(int)> sig2(&resource);
+            sig1.add<&DisconnectableObserver::set_value>(&observer);
+            sig2.add<&DisconnectableObserver::set_value>(&observer);
+            sig2.add<&DisconnectableObserver::set_value>(&observer);
+
+            MemoryUsage usage = observer.memory_usage();
+            EXPECT_EQ(usage.slots, 3);
+            EXPECT_EQ(usage.tombstones, 0);
+            EXPECT_GE(usage.capacity, 3);
+        }
+
+        // The connections to the destroyed signal expired, their records stay allocated until dropped
+        MemoryUsage usage = observer.memory_usage();
+        EXPECT_EQ(usage.slots, 1);
+        EXPECT_EQ(usage.tombstones, 2);
+        EXPECT_EQ(resource.bytes, sig1.memory_usage().heap_bytes + 2 * internal::connection_record_bytes());
+
+        observer.shrink_to_fit();
+        usage = observer.memory_usage();
+        EXPECT_EQ(usage.slots, 1);
+        EXPECT_EQ(usage.tombstones, 0);
+        EXPECT_EQ(usage.capacity, 1);
+        EXPECT_EQ(resource.bytes, sig1.memory_usage().heap_bytes);
+    }
+    EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(FastSignalTest, test_signal_add_range)
+{
+    struct Counter {
+        int value = 0;
+        void add(int x) { value += x; }
+    };
+
+    struct DisconnectableCounter : public Disconnectable {
+        int value = 0;
+        void add(int x) { value += x; }
+    };
+
+    CountingResource resource;
+    {
+        FastSignal<void(int)> sig(&resource);
+        std::vector<Counter> counters(100);
+        sig.add_range<&Counter::add>(counters.begin(), counters.end());
+        EXPECT_EQ(sig.count(), 100);
+        // The slot arrays, the anchor, the block of connections and its control block
+        EXPECT_EQ(resource.allocations, 5);
+
+        Counter extra;
+        std::vector<Counter*> pointers{&extra, &counters[0]};
+        sig.add_range<&Counter::add>(pointers.begin(), pointers.end());
+        EXPECT_EQ(sig.count(), 102);
+
+        sig(2);
+        EXPECT_EQ(extra.value, 2);
+        EXPECT_EQ(counters[0].value, 4);
+        EXPECT_EQ(counters[99].value, 2);
+
+        // Slots of a range are disconnected one by one, the block stays until the last of them
+        {
+            std::vector<DisconnectableCounter> observers(10);
+            sig.add_range<&DisconnectableCounter::add>(observers.begin(), observers.end());
+            EXPECT_EQ(sig.count(), 112);
+            EXPECT_EQ(observers[3].memory_usage().slots, 1);
+
+            sig(1);
+            EXPECT_EQ(observers[9].value, 1);
+
+            observers.pop_back();
+            EXPECT_EQ(sig.count(), 111);
+            sig(1);
+            EXPECT_EQ(observers[8].value, 2);
+        }
+        EXPECT_EQ(sig.count(), 102);
+        sig(1);
+        EXPECT_EQ(extra.value, 5);
+
+        std::vector<Counter> none;
+        sig.add_range<&Counter::add>(none.begin(), none.end());
+        EXPECT_EQ(sig.count(), 102);
+    }
+    EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(FastSignalTest, test_signal_reserve)
+{
+    CountingResource resource;
+    FastSignal<void(int)> sig(&resource);
+    sig.reserve(200);
+    EXPECT_GE(sig.memory_usage().capacity, 200);
+
+    size_t allocations = resource.allocations;
+    for (int i = 0; i < 200; ++i)
+        sig.add(set_global_value1);
+    // Only the anchor and the connection records
+    EXPECT_EQ(resource.allocations, allocations + 1 + 200);
+
+    sig(7);
+    EXPECT_EQ(global_value1, 7);
+}
+
+TEST_F(FastSignalTest, test_signal_add_permanent)
+{
+    struct Counter {
+        int value = 0;
+        void add(int x) { value += x; }
+    };
+
+    CountingResource resource;
+    {
+        std::vector<Counter> counters(64);
+        FastSignal<void(int)> sig(&resource);
+        sig.reserve(counters.size() + 2);
+        size_t allocations = resource.allocations;
+
+        for (auto &counter : counters)
+            sig.add_permanent<&Counter::add>(&counter);
+        sig.add_permanent(set_global_value1);
+        // No connection record, no anchor
+        EXPECT_EQ(resource.allocations, allocations);
+        EXPECT_EQ(sig.count(), 65);
+
+        sig(2);
+        EXPECT_EQ(counters[0].value, 2);
+        EXPECT_EQ(counters[63].value, 2);
+        EXPECT_EQ(global_value1, 2);
+
+        // Compaction moves the permanent slots along with the others
+        auto connection = sig.add(set_global_value2);
+        Counter blocked;
+        auto blocked_connection = sig.add<&Counter::add>(&blocked);
+        blocked_connection.block();
+        connection.disconnect();
+        sig.add_permanent<&Counter::add>(&counters[0]);
+        sig(1);
+        EXPECT_EQ(global_value2, 0);
+        EXPECT_EQ(counters[0].value, 4);
+        EXPECT_EQ(sig.count(), 67);
+
+        blocked_connection.unblock();
+        sig(1);
+        EXPECT_EQ(blocked.value, 1);
+        EXPECT_EQ(counters[0].value, 6);
+
+        FastSignal<void(int)> moved(std::move(sig));
+        moved(1);
+        EXPECT_EQ(counters[1].value, 5);
+        EXPECT_EQ(blocked.value, 2);
+    }
+    EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(FastSignalTest, test_signal_connect_all)
+{
+    struct MultiObserver : public Disconnectable {
+        int value = 0;
+        double real = 0;
+        void on_int(int x) { value += x; }
+        void on_double(double x) { real += x; }
+        void on_void() { ++value; }
+    };
+
+    FastSignal<void(int)> sig_int;
+    FastSignal<void(double)> sig_double;
+    FastSignal<void()> sig_void;
+    {
+        MultiObserver observer;
+        connect_all<&MultiObserver::on_int, &MultiObserver::on_double, &MultiObserver::on_void>(
+            &observer, sig_int, sig_double, sig_void);
+        EXPECT_EQ(sig_int.count(), 1);
+        EXPECT_EQ(sig_double.count(), 1);
+        EXPECT_EQ(sig_void.count(), 1);
+        // One connection for the three signals
+        EXPECT_EQ(observer.memory_usage().slots, 1);
+
+        sig_int(2);
+        sig_double(0.5);
+        sig_void();
+        EXPECT_EQ(observer.value, 3);
+        EXPECT_EQ(observer.real, 0.5);
+
+        // Follows the object when it is moved
+        MultiObserver moved(std::move(observer));
+        sig_void();
+        EXPECT_EQ(moved.value, 4);
+    }
+    EXPECT_EQ(sig_int.count(), 0);
+    EXPECT_EQ(sig_double.count(), 0);
+    EXPECT_EQ(sig_void.count(), 0);
+
+    // The view blocks and disconnects all the slots
+    struct Counter {
+        int value = 0;
+        void on_int(int x) { value += x; }
+        void on_void() { ++value; }
+    };
+    Counter counter;
+    ConnectionView connection = connect_all<&Counter::on_int, &Counter::on_void>(&counter, sig_int, sig_void);
+    connection.block();
+    sig_int(5);
+    sig_void();
+    EXPECT_EQ(counter.value, 0);
+    connection.unblock();
+    sig_int(5);
+    sig_void();
+    EXPECT_EQ(counter.value, 6);
+    connection.disconnect();
+    sig_int(5);
+    sig_void();
+    EXPECT_EQ(counter.value, 6);
+    EXPECT_EQ(sig_int.count(), 0);
+
+    // A destroyed signal leaves the others connected
+    MultiObserver observer;
+    {
+        FastSignal<void(int)> short_lived;
+        connect_all<&MultiObserver::on_int, &MultiObserver::on_void>(&observer, short_lived, sig_void);
+    }
+    sig_void();
+    EXPECT_EQ(observer.value, 1);
+    EXPECT_EQ(observer.memory_usage().slots, 1);
+}
+
+TEST_F(FastSignalTest, test_signal_teardown_scope)
+{
+    struct Counter : public Disconnectable {
+        explicit Counter(std::pmr::memory_resource *mr) : Disconnectable(mr) {}
+        int value = 0;
+        void add(int x) { value += x; }
+    };
+
+    CountingResource resource;
+    for (bool signals_first : {false, true}) {
+        {
+            TeardownScope teardown;
+            // The objects are destroyed in the reverse order of their adoption
+            std::pmr::vector<Counter> *counters = nullptr;
+            if (signals_first)
+                counters = &teardown.make<std::pmr::vector<Counter>>(&resource);
+            auto &sig1 = teardown.make<FastSignal<void(int)>>(&resource);
+            auto &sig2 = teardown.adopt(std::make_unique<FastSignal<void(int)>>(&resource));
+            if (!signals_first)
+                counters = &teardown.make<std::pmr::vector<Counter>>(&resource);
+
+            counters->reserve(100);
+            for (int i = 0; i < 100; ++i) {
+                Counter &counter = counters->emplace_back(&resource);
+                sig1.add<&Counter::add>(&counter);
+                sig2.add<&Counter::add>(&counter);
+            }
+            sig1.add(set_global_value1);
+            sig1(1);
+            EXPECT_EQ(counters->back().value, 1);
+        }
+        EXPECT_EQ(resource.bytes, 0);
+    }
+
+    // Outside the scope, destruction disconnects as usual
+    FastSignal<void(int)> sig(&resource);
+    {
+        Counter counter(&resource);
+        sig.add<&Counter::add>(&counter);
+        EXPECT_EQ(sig.count(), 1);
+    }
+    EXPECT_EQ(sig.count(), 0);
+}
+
+TEST_F(FastSignalTest, test_signal_teardown_scope_other_objects)
+{
+    struct Counter : public Disconnectable {
+        int value = 0;
+        void add(int x) { value += x; }
+    };
+
+    // Disconnects its connection itself
+    struct Holder {
+        ConnectionView connection;
+        ~Holder() { connection.disconnect(); }
+    };
+
+    FastSignal<void(int)> outside;
+    Counter counter;
+    {
+        TeardownScope teardown;
+        // The objects the scope doesn't own disconnect as usual while it is alive
+        {
+            Counter other;
+            outside.add<&Counter::add>(&other);
+        }
+        EXPECT_EQ(outside.count(), 0);
+
+        // inside is destroyed first, then holder disconnects the record it shared with outside
+        Holder &holder = teardown.make<Holder>();
+        auto &inside = teardown.make<FastSignal<void(int)>>();
+        holder.connection = connect_all<&Counter::add, &Counter::add>(&counter, outside, inside);
+        inside(1);
+        EXPECT_EQ(counter.value, 1);
+    }
+    EXPECT_EQ(outside.count(), 0);
+    outside(2);
+    EXPECT_EQ(counter.value, 1);
+}
@@ -0,0 +1,173 @@
+#include <regex>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include "fastsignal.hpp"
+
+using namespace fastsignal;
+
+#ifndef FASTSIGNAL_TRACE
+#error "fastsignal_trace_tests must be built with FASTSIGNAL_TRACE"
+#endif
+
+struct TraceEvent {
+    std::string name;
+    double ts = 0;
+    double dur = 0;
+    int tid = 0;
+    std::string target;
+};
+
+struct Recorder {
+    int calls = 0;
+    void on_value(int) { ++calls; }
+};
+
+// Checks the overall structure of the file and parses its events, one per line
+static std::vector<TraceEvent> read_trace(const std::string &path)
+{
+    std::ifstream in(path);
+    std::string line;
+    std::vector<TraceEvent> events;
+
+    EXPECT_TRUE(std::getline(in, line));
+    EXPECT_EQ(line, "{\"traceEvents\":[");
+
+    const std::regex event_regex(
+        "\\{\"name\":\"(emit|slot)\",\"cat\":\"fastsignal\",\"ph\":\"X\","
+        "\"ts\":([0-9]+\\.[0-9]{3}),\"dur\":([0-9]+\\.[0-9]{3}),"
+        "\"pid\":1,\"tid\":([0-9]+),\"args\":\\{\"(signal|slot)\":\"([0-9a-fx]+)\"\\}\\},?");
+
+    bool closed = false;
+    while (std::getline(in, line)) {
+        std::smatch match;
+        if (std::regex_match(line, match, event_regex)) {
+            EXPECT_FALSE(closed);
+            EXPECT_EQ(match[1] == "emit", match[5] == "signal");
+            events.push_back({match[1], std::stod(match[2]), std::stod(match[3]), std::stoi(match[4]), match[6]});
+        } else {
+            EXPECT_EQ(line, "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":0}}");
+            closed = true;
+        }
+    }
+    EXPECT_TRUE(closed);
+
+    return events;
+}
+
+static std::string address(const void *ptr)
+{
+    std::ostringstream out;
+    out << ptr;
+    return out.str();
+}
+
+class FastSignalTraceTest : public ::testing::Test
+{
+protected:
+    std::string path = "fastsignal_trace_test.json";
+
+    void SetUp() override
+    {
+        trace::clear();
+        trace::set_slot_spans(false);
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(FastSignalTraceTest, test_trace_emissions)
+{
+    FastSignal<void(int)> sig;
+    Recorder recorder1, recorder2;
+    sig.add<&Recorder::on_value>(&recorder1);
+    sig.add<&Recorder::on_value>(&recorder2);
+
+    sig(1);
+    sig(2);
+    sig.block();
+    sig(3);
+
+    ASSERT_TRUE(trace::write_chrome_trace(path.c_str()));
+    std::vector<TraceEvent> events = read_trace(path);
+
+    // Blocked emissions are not recorded, slots only when enabled
+    ASSERT_EQ(events.size(), 2u);
+    for (auto &event : events) {
+        EXPECT_EQ(event.name, "emit");
+        EXPECT_EQ(event.target, address(&sig));
+    }
+    EXPECT_LE(events[0].ts + events[0].dur, events[1].ts);
+
+    // The caller's stream formatting is left as it was
+    std::ostringstream out;
+    out.precision(9);
+    trace::write_chrome_trace(out);
+    EXPECT_EQ(out.precision(), 9);
+    EXPECT_EQ(out.flags(), std::ostringstream().flags());
+}
+
+TEST_F(FastSignalTraceTest, test_trace_slots)
+{
+    trace::set_slot_spans(true);
+
+    struct Relay {
+        FastSignal<void(int)> *next;
+        void on_value(int x) { (*next)(x); }
+    };
+
+    FastSignal<void(int)> sig, next;
+    Recorder recorder;
+    Relay relay{&next};
+    sig.add<&Relay::on_value>(&relay);
+    next.add<&Recorder::on_value>(&recorder);
+
+    sig(1);
+
+    ASSERT_TRUE(trace::write_chrome_trace(path.c_str()));
+    std::vector<TraceEvent> events = read_trace(path);
+
+    // Recorded when they end, the innermost first
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].name, "slot");
+    EXPECT_EQ(events[0].target, address(&recorder));
+    EXPECT_EQ(events[1].name, "emit");
+    EXPECT_EQ(events[1].target, address(&next));
+    EXPECT_EQ(events[2].name, "slot");
+    EXPECT_EQ(events[2].target, address(&relay));
+    EXPECT_EQ(events[3].name, "emit");
+    EXPECT_EQ(events[3].target, address(&sig));
+
+    // Each span is inside the one that recorded after it
+    for (size_t i = 0; i + 1 < events.size(); ++i) {
+        EXPECT_GE(events[i].ts, events[i + 1].ts);
+        EXPECT_LE(events[i].ts + events[i].dur, events[i + 1].ts + events[i + 1].dur);
+    }
+}
+
+TEST_F(FastSignalTraceTest, test_trace_threads)
+{
+    FastSignal<void(int)> sig1, sig2;
+    Recorder recorder;
+    sig1.add<&Recorder::on_value>(&recorder);
+    sig2.add<&Recorder::on_value>(&recorder);
+
+    sig1(1);
+    std::thread([&sig2]() { sig2(2); }).join();
+
+    ASSERT_TRUE(trace::write_chrome_trace(path.c_str()));
+    std::vector<TraceEvent> events = read_trace(path);
+
+    ASSERT_EQ(events.size(), 2u);
+    const TraceEvent &event1 = events[0].target == address(&sig1) ? events[0] : events[1];
+    const TraceEvent &event2 = events[0].target == address(&sig2) ? events[0] : events[1];
+    EXPECT_EQ(event1.target, address(&sig1));
+    EXPECT_EQ(event2.target, address(&sig2));
+    EXPECT_NE(event1.tid, event2.tid);
+}